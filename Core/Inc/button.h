@@ -8,11 +8,16 @@
 /* Includes */
 #include <stdint.h>
 
+/* Defines */
+#define BUTTON_SCAN_MS 5	// 200 Hz shift-register read
+
 /* Variables */
-extern uint16_t button_count[16];
+extern uint32_t button_missed;
+extern uint32_t button_skipped;
 
 /* Functions */
 extern void button_init();
-extern void button_scan();
+extern void button_timer_tick();
+extern uint8_t button_take(uint16_t *held);
 
 #endif /* INC_BUTTON_H_ */
@@ -0,0 +1,28 @@
+/*
+ * console.h
+ *
+ * Debug console on USART1 TX (PA9, 115200 8N1): printf() lands here through
+ * __io_putchar(). Characters go into a ring that the USART1 interrupt
+ * empties, so a report line costs the caller a copy, not the line time.
+ */
+
+#ifndef INC_CONSOLE_H_
+#define INC_CONSOLE_H_
+
+/* Includes */
+#include <stdint.h>
+
+/* Defines */
+#define CONSOLE_BAUD 115200
+#define CONSOLE_TX_SIZE 1024		// bytes waiting for the wire
+
+/* Variables */
+extern uint32_t console_waits;		// characters that had to wait for room
+
+/* Functions */
+extern void console_init(void);
+extern void console_putc(char c);
+extern uint16_t console_room(void);
+extern void console_irq(void);
+
+#endif /* INC_CONSOLE_H_ */
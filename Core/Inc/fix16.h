@@ -0,0 +1,40 @@
+/*
+ * fix16.h
+ *
+ * Q16.16 fixed-point arithmetic for the game physics.
+ */
+
+#ifndef INC_FIX16_H_
+#define INC_FIX16_H_
+
+#include <stdint.h>
+
+typedef int32_t fix16_t;
+
+#define FIX16_SHIFT 16
+#define FIX16_ONE ((fix16_t)1 << FIX16_SHIFT)
+
+// Constant from a literal, folded at compile time: FIX16_CONST(0.7071)
+#define FIX16_CONST(v) ((fix16_t)((v) * 65536.0 + ((v) >= 0 ? 0.5 : -0.5)))
+#define FIX16_FROM_INT(i) ((fix16_t)(i) * FIX16_ONE)
+// Integer part, rounded towards minus infinity
+#define FIX16_TO_INT(f) ((int16_t)((f) >> FIX16_SHIFT))
+// Time step in seconds from milliseconds, rounded to nearest
+#define FIX16_FROM_MS(ms) ((fix16_t)(((int32_t)(ms) * FIX16_ONE + 500) / 1000))
+
+static inline fix16_t fix16_mul(fix16_t a, fix16_t b) {
+    return (fix16_t)(((int64_t)a * b) >> FIX16_SHIFT);
+}
+
+static inline fix16_t fix16_abs(fix16_t a) {
+    return a < 0 ? -a : a;
+}
+
+/**
+ * @brief num / den as a fixed-point value.
+ */
+static inline fix16_t fix16_from_ratio(int32_t num, int32_t den) {
+    return (fix16_t)(((int64_t)num * FIX16_ONE) / den);
+}
+
+#endif /* INC_FIX16_H_ */
@@ -0,0 +1,34 @@
+/*
+ * frame_scheduler.h
+ */
+
+#ifndef INC_FRAME_SCHEDULER_H_
+#define INC_FRAME_SCHEDULER_H_
+
+/* Includes */
+#include "stdint.h"
+
+/* Defines */
+#define FRAME_STEP_MS 20		// fixed physics step (50 Hz)
+#define FRAME_MAX_SUBSTEPS 4	// steps per render before time is dropped
+
+/* Types */
+typedef struct {
+	uint32_t last_tick;		// HAL_GetTick() at the previous poll
+	uint32_t accumulator;	// simulation time owed, in ms
+	uint32_t frames;		// polls that ran steps, one render each
+	uint32_t steps;			// physics steps run
+	uint32_t skipped;		// renders skipped: steps beyond one per frame
+	uint32_t overruns;		// frames that hit FRAME_MAX_SUBSTEPS
+	uint32_t dropped_ms;	// time the cap threw away; the game ran slow by this
+} frame_scheduler_t;
+
+/* Variables */
+extern frame_scheduler_t frame_scheduler;
+
+/* Functions */
+extern void frame_scheduler_init(void);
+extern void frame_scheduler_resync(void);
+extern uint8_t frame_scheduler_poll(void);
+
+#endif /* INC_FRAME_SCHEDULER_H_ */
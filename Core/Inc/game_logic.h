@@ -3,12 +3,24 @@
 
 
 // --- Parameter for logic ---
+// (overridable with -D so the batch simulator can sweep them)
+#ifndef V_MIN
 #define V_MIN 100
+#endif
+#ifndef V_MAX
 #define V_MAX 220
+#endif
+#ifndef V_X_MAX
 #define V_X_MAX 180
+#endif
+#ifndef K_SPIN
 #define K_SPIN 0.18f
-#define CRIT45_SCALE 0.7071f // cos(45°) or sin(45°)
-#define CRIT45_FLOOR 2.0f
+#endif
+#define K_SPIN_FIX FIX16_CONST(K_SPIN) // ball dx gained per px/s of paddle velocity
+#define PADDLE_V_MAX 600 // px/s; clamps knob jumps before they reach the spin
+#define PADDLE_V_SHIFT 1 // velocity smoothing: each sample moves it 1/2 of the way
+#define CRIT45_SCALE FIX16_CONST(0.7071) // cos(45°) or sin(45°)
+#define CRIT45_FLOOR FIX16_CONST(2.0)
 
 
 // --- Macro for clamping values ---
@@ -22,7 +34,8 @@ uint8_t resolve_ball_brick(Ball *ball, Brick *brick);
 uint8_t resolve_ball_paddle(Ball *ball, const Paddle *paddle);
 uint8_t resolve_ball_wall(Ball *ball);
 void initialize_ball_velocity(Ball *ball);
-void step_world(GameState *state, float dt);
+void step_world(GameState *state, fix16_t dt);
 
-// for future paddle mechanics 
-void apply_spin_to_ball(Ball *ball, int16_t paddle_dx);
+// Paddle kinematics and spin
+void game_track_paddle(Paddle *paddle, fix16_t dt);
+void apply_spin_to_ball(Ball *ball, fix16_t paddle_velocity);
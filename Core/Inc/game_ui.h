@@ -7,6 +7,7 @@
 
 #include <stdint.h>
 #include "lcd.h"
+#include "fix16.h"
 
 #define SCREEN_WIDTH 240
 #define SCREEN_HEIGHT 320
@@ -17,6 +18,16 @@
 #define BRICK_COLS 7
 #define BRICK_WIDTH 32
 #define BRICK_HEIGHT 16
+// Brick grid layout: bricks sit on a regular grid, centered horizontally
+#define BRICK_PITCH_X (BRICK_WIDTH + BRICK_GAP)
+#define BRICK_PITCH_Y (BRICK_HEIGHT + BRICK_GAP)
+#define GRID_PADDING_X ((SCREEN_WIDTH - (BRICK_COLS * BRICK_WIDTH) - ((BRICK_COLS - 1) * BRICK_GAP)) / 2)
+#define GRID_START_Y (UI_BAR_HEIGHT + 20)
+// Bits of a full row in GameState.brick_alive (one bit per column)
+#define BRICK_ROW_MASK (BRICK_COLS >= 32 ? 0xFFFFFFFFUL : ((1UL << BRICK_COLS) - 1))
+#if BRICK_COLS > 32
+#error "brick_alive holds at most 32 columns per row"
+#endif
 
 #define PADDLE_WIDTH 60
 #define PADDLE_HEIGHT 10
@@ -48,27 +59,40 @@ typedef enum {
     BRICK_SPECIAL_PLUS
 } BrickSpecial;
 
+// Chance (percent) a new brick is special; -D overridable for tuning runs
+#ifndef BRICK_BALL_PERCENT
+#define BRICK_BALL_PERCENT 5
+#endif
+#ifndef BRICK_PLUS_PERCENT
+#define BRICK_PLUS_PERCENT 10
+#endif
+
 // Structure for a single brick
 typedef struct {
-    uint16_t x, y;
+    uint16_t x;
+    int16_t y;               // negative while above the screen
     uint16_t width, height;
     uint16_t color;
     BrickState state;
     BrickSpecial special;
     int16_t final_y;         // target y position after drop completes
-    uint8_t drop_speed;      // pixels per frame to drop
+    uint8_t drop_speed;      // pixels per physics step to drop
     // uint8_t hp; // Use in the future for multi-hit bricks
 } Brick;
 
 // Structure for the ball
 typedef struct {
-    int16_t x, y;
-    int16_t prev_x, prev_y; // Previous position for efficient redraw
-    int16_t dx, dy;
+    fix16_t x, y;           // Center, Q16.16 pixels
+    int16_t prev_x, prev_y; // Previous pixel position for efficient redraw
+    fix16_t dx, dy;         // Velocity, Q16.16 pixels per second
     uint16_t color;
     uint8_t radius;
 } Ball;
 
+// Pixel the ball center is drawn at
+#define BALL_PX(ball) FIX16_TO_INT((ball)->x)
+#define BALL_PY(ball) FIX16_TO_INT((ball)->y)
+
 // Structure for the paddle
 typedef struct {
     uint16_t x, y; // Top-left corner
@@ -77,27 +101,67 @@ typedef struct {
     uint16_t height;
     uint16_t color;
     uint16_t speed; // Pixels per frame
+    uint16_t sample_x; // x at the last velocity sample (game_track_paddle)
+    fix16_t velocity; // px/s, smoothed from the sampled positions
 } Paddle;
 
+// What step_world reports to the renderer instead of drawing itself
+typedef enum {
+    GAME_EVENT_BRICK_DESTROYED,
+    GAME_EVENT_BALL_LOST,
+    GAME_EVENT_LEVEL_ADVANCED,
+    GAME_EVENT_LIFE_LOST,
+    GAME_EVENT_GAME_OVER
+} GameEventType;
+
+typedef struct {
+    uint8_t type;              // GameEventType
+    uint8_t row, col;          // BRICK_DESTROYED
+    uint8_t radius;            // BALL_LOST
+    int16_t x, y;              // BALL_LOST: last position
+    int16_t prev_x, prev_y;    // BALL_LOST: where it was last drawn
+} GameEvent;
+
+#define GAME_EVENT_QUEUE_SIZE 32
+
+// Fixed-size ring, filled by the physics steps and drained once per frame
+typedef struct {
+    GameEvent events[GAME_EVENT_QUEUE_SIZE];
+    uint8_t head;              // oldest event
+    uint8_t count;
+    uint8_t overflow;          // events were dropped; the drain redraws all
+} GameEventQueue;
+
 // Structure for the entire game state
 typedef struct {
     Brick bricks[BRICK_ROWS][BRICK_COLS];
+    uint32_t brick_alive[BRICK_ROWS]; // bit col set: brick not destroyed
+    uint16_t bricks_left;             // set bits in brick_alive
     Ball balls[MAX_BALLS];
     uint8_t ball_count;
     Paddle paddle;
     uint32_t score;
     uint8_t lives;
     uint8_t level;
-    int16_t brick_drop_offset; // negative while bricks are dropping in
+    int16_t brick_drop_offset; // negative while bricks are dropping in; all
+                               // incoming bricks sit at final_y + offset
     uint8_t brick_dropping;
     GameStatus status;
     uint8_t show_potentiometer_prompt;
+    int16_t pot_last; // knob position the paddle last followed, -1 before the first
+    uint32_t balls_lost; // balls that fell past the paddle this game
+    GameEventQueue events;
+    uint32_t rng; // xorshift32 state; only game_seed() sets it, so restarts
+                  // continue the same sequence
 } GameState;
 
 // --- Function Prototypes ---
 
 // Initialization
 void game_init_state(GameState *state);
+// Game randomness comes only from here, so a seed reproduces a session
+void game_seed(GameState *state, uint32_t seed);
+uint32_t game_rand(GameState *state);
 
 // Start Screen
 void game_draw_start_screen(void);
@@ -105,6 +169,11 @@ void game_draw_start_screen(void);
 // Full Draw (called once at the beginning)
 void game_draw_initial_scene(const GameState *state);
 void game_update_screen(GameState *state);
+// Draw what the events since the last call changed (once per frame)
+void game_render_events(GameState *state);
+// Event queue between step_world (game_logic.c) and the renderer
+void game_push_event(GameState *state, const GameEvent *event);
+uint8_t game_pop_event(GameState *state, GameEvent *event);
 
 // Pause Screen
 void game_draw_pause_screen(const GameState *state);
@@ -121,13 +190,21 @@ void game_update_ui_bar(uint32_t score, uint8_t lives, uint8_t level);
 void draw_game_border(void);
 void draw_potentiometer_prompt();
 void game_erase_ball(const Ball *ball);
+// Dirty-rectangle compositor for the play area
+void game_mark_dirty(int16_t x1, int16_t y1, int16_t x2, int16_t y2);
+void game_flush_dirty(const GameState *state);
 
 // Special brick effects
 void spawn_extra_ball(GameState *state, const Ball *template_ball);
 void apply_plus_powerup(GameState *state);
-// Move paddle using two hardware buttons (button_count[5] = left, [6] = right)
+// Move paddle using two hardware buttons (8 = left, 9 = right);
+// once per physics step
 void game_handle_paddle_buttons(GameState *state);
+// Move paddle to the potentiometer position when the knob turned; returns 1
+// if it turned (the prompt only reports it)
+uint8_t game_handle_paddle_pot(GameState *state, uint8_t position);
 // Level management
 void advance_level(GameState *state);
+void game_advance_drop(GameState *state);
 void init_bricks_for_level(GameState *state, uint8_t level, uint8_t animate);
 #endif /* INC_GAME_UI_H_ */
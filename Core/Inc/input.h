@@ -0,0 +1,59 @@
+/*
+ * input.h
+ *
+ * Turns button scans into debounced press/release/hold/repeat events and
+ * measures how long a press takes to reach the screen.
+ */
+
+#ifndef INC_INPUT_H_
+#define INC_INPUT_H_
+
+/* Includes */
+#include <stdint.h>
+
+/* Defines */
+#define INPUT_QUEUE_SIZE 32
+#define INPUT_LATENCY_MAX_MS 1000	// older presses count as stale, not latency
+
+/* Types */
+typedef enum {
+	INPUT_PRESS,
+	INPUT_RELEASE,
+	INPUT_HOLD,					// held for hold_ms
+	INPUT_REPEAT				// every repeat_ms after the hold
+} input_event_type_t;
+
+typedef struct {
+	uint8_t type;				// input_event_type_t
+	uint8_t button;				// bit index in button_decode()'s held mask
+	uint32_t time;				// input clock (ms), see input_config_t.scan_ms
+} input_event_t;
+
+typedef struct {
+	uint16_t scan_ms;			// input clock advance per input_update()
+	uint16_t debounce_ms;		// a level must hold this long to count, 0 = off
+	uint16_t hold_ms;			// press to INPUT_HOLD, 0 = no hold or repeat
+	uint16_t repeat_ms;			// INPUT_REPEAT period after the hold, 0 = off
+} input_config_t;
+
+typedef struct {
+	uint32_t count;				// presses that reached the screen
+	uint32_t stale;				// presses no frame reflected in time
+	uint32_t min;				// ms, press scan to presented frame
+	uint32_t max;
+	uint32_t total;
+} input_latency_t;
+
+/* Variables */
+extern input_config_t input_config;
+extern input_latency_t input_latency;
+extern uint32_t input_overflow;
+
+/* Functions */
+extern void input_init(const input_config_t *config);
+extern void input_update(uint16_t held);
+extern uint8_t input_pop(input_event_t *event);
+extern uint8_t input_held(uint8_t button);
+extern void input_frame_presented(void);
+
+#endif /* INC_INPUT_H_ */
@@ -22,9 +22,6 @@
 #define D2U_L2R  0xa0
 #define D2U_R2L  0xe0
 
-// LCD
-#define LCD_BASE        ((uint32_t)(0x60000000 | 0x000ffffe))
-#define LCD             ((LCD_TypeDef *) LCD_BASE)
 // Color
 #define WHITE         	 0xFFFF
 #define BLACK         	 0x0000
@@ -57,11 +54,25 @@ typedef struct {
 	uint16_t id;
 } _lcd_dev;
 
+#ifdef HOST_BUILD
+// Host build: bus accesses are decoded by the ILI9341 emulator
+#include "host_lcd.h"
+#else
 typedef struct {
 	__IO uint16_t LCD_REG;
 	__IO uint16_t LCD_RAM;
 } LCD_TypeDef;
 
+// LCD
+#define LCD_BASE        ((uint32_t)(0x60000000 | 0x000ffffe))
+#define LCD             ((LCD_TypeDef *) LCD_BASE)
+
+// Bus access
+#define LCD_BUS_WR_REG(reg)   (LCD->LCD_REG = (reg))
+#define LCD_BUS_WR_DATA(data) (LCD->LCD_RAM = (data))
+#define LCD_BUS_RD_DATA()     (LCD->LCD_RAM)
+#endif
+
 /* Variables */
 extern _lcd_dev lcddev;
 
@@ -73,11 +84,18 @@ void lcd_set_display_off(void);
 uint16_t lcd_read_point(uint16_t x, uint16_t y);
 void lcd_clear(uint16_t color);
 
+uint8_t lcd_dma_busy(void);
+void lcd_dma_wait(void);
+void lcd_dma_set_callback(void (*callback)(void));
+
 void lcd_fill(uint16_t xsta, uint16_t ysta, uint16_t xend, uint16_t yend,
 		uint16_t color);
+void lcd_write_pixels(const uint16_t *pixels, uint32_t count);
 void lcd_draw_point(uint16_t x, uint16_t y, uint16_t color);
 void lcd_draw_line(uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2,
 		uint16_t color);
+void lcd_draw_hline(uint16_t x, uint16_t y, uint16_t length, uint16_t color);
+void lcd_draw_vline(uint16_t x, uint16_t y, uint16_t length, uint16_t color);
 void lcd_draw_rectangle(uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2,
 		uint16_t color);
 
@@ -89,12 +107,18 @@ void lcd_show_float_num(uint16_t x, uint16_t y, float num, uint8_t len,
 		uint16_t fc, uint16_t bc, uint8_t sizey);
 
 void lcd_show_picture(uint16_t x, uint16_t y, uint16_t length, uint16_t width,
-		const uint8_t pic[]);
+		const uint16_t pic[]);
+void lcd_show_picture_region(uint16_t x, uint16_t y, uint16_t length,
+		uint16_t width, const uint16_t pic[], uint16_t pic_length,
+		uint16_t src_x, uint16_t src_y);
 
 void lcd_set_direction(uint8_t dir);
 void lcd_init(void);
 
 void lcd_draw_circle(int xc, int yc, uint16_t c, int r, int fill);
+void lcd_fill_circle(int xc, int yc, int r, uint16_t c);
+const uint16_t* lcd_circle_spans(int r);
+void lcd_circle_outline_rows(int r, uint32_t *rows);
 void lcd_show_string(uint16_t x, uint16_t y, char *str, uint16_t fc, uint16_t bc,
 		uint8_t sizey, uint8_t mode);
 void lcd_show_string_center(uint16_t x, uint16_t y, char *str, uint16_t fc, uint16_t bc,
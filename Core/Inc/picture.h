@@ -8,5 +8,8 @@
 #ifndef INC_PICTURE_H_
 #define INC_PICTURE_H_
 
-extern const unsigned char gImage_BK[153608];
+#include <stdint.h>
+
+// 240x320 RGB565, one native word per pixel
+extern const uint16_t gImage_BK[76800];
 #endif /* INC_PICTURE_H_ */
@@ -0,0 +1,30 @@
+/*
+ * potentiometer.h
+ *
+ * ADC1 converts its five inputs on every TIM2 update (1 kHz) into a circular
+ * DMA ring; the half- and full-transfer interrupts filter the potentiometer
+ * samples into a paddle position. Nothing is polled from the main loop.
+ * The ADC runs at PCLK2 / 4 (10.5 MHz) with 84-cycle samples, long enough
+ * for the pot's source impedance; a sequence takes about 46 us.
+ */
+
+#ifndef INC_POTENTIOMETER_H_
+#define INC_POTENTIOMETER_H_
+
+/* Includes */
+#include <stdint.h>
+
+/* Defines */
+#define POTENTIOMETER_CHANNELS 5		// ADC1 sequence: IN8..IN12
+#define POTENTIOMETER_RANK 3			// IN11, fourth conversion of the sequence
+#define POTENTIOMETER_RING_SCANS 8		// an interrupt every 4 scans (4 ms)
+#define POTENTIOMETER_POSITION_MAX 255
+
+/* Variables */
+extern uint32_t potentiometer_blocks;	// half-ring blocks filtered
+
+/* Functions */
+extern void potentiometer_init(void);
+extern uint8_t potentiometer_read(void);
+
+#endif /* INC_POTENTIOMETER_H_ */
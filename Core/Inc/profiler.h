@@ -0,0 +1,79 @@
+/*
+ * profiler.h
+ *
+ * Scoped-zone profiler. On the target zones are timed with the DWT cycle
+ * counter, on the host build with clock_gettime(); both report in the same
+ * format. Build with PROFILER_ENABLED=0 and every call compiles away.
+ * The Debug configuration defines PROFILER_ENABLED=1 (Project > Properties >
+ * C/C++ Build > Settings > MCU GCC Compiler > Preprocessor), Release leaves
+ * it off; the host Makefile turns it on. Reports go to the debug console.
+ */
+
+#ifndef INC_PROFILER_H_
+#define INC_PROFILER_H_
+
+/* Includes */
+#include "stdint.h"
+
+/* Defines */
+#ifndef PROFILER_ENABLED
+#define PROFILER_ENABLED 0
+#endif
+
+#define PROFILER_HIST_BUCKETS 12	// bucket b counts [2^(b-1), 2^b) us, the last one is open-ended
+#define PROFILER_RING_SIZE 64		// most recent samples kept for a post-mortem look
+
+/* Types */
+typedef enum {
+	PROF_ZONE_FRAME,			// one scheduler frame: all steps plus the render
+	PROF_ZONE_BUTTON_SCAN,
+	PROF_ZONE_STEP_WORLD,
+	PROF_ZONE_UPDATE_SCREEN,
+	PROF_ZONE_TIMER_ISR,		// HAL_TIM_PeriodElapsedCallback
+	PROF_ZONE_COUNT
+} profiler_zone_t;
+
+typedef struct {
+	uint32_t count;
+	uint32_t min;				// ticks
+	uint32_t max;				// ticks
+	uint64_t total;				// ticks
+	uint32_t hist[PROFILER_HIST_BUCKETS];
+} profiler_stats_t;
+
+typedef struct {
+	uint8_t zone;
+	uint32_t ticks;
+} profiler_sample_t;
+
+// Receives one report line at a time, without a line terminator
+typedef void (*profiler_output_t)(const char *line);
+
+#if PROFILER_ENABLED
+
+/* Variables */
+extern profiler_stats_t profiler_stats[PROF_ZONE_COUNT];
+extern profiler_sample_t profiler_ring[PROFILER_RING_SIZE];
+extern uint16_t profiler_ring_head;
+
+/* Functions */
+extern void profiler_init(void);
+extern void profiler_reset(void);
+extern uint32_t profiler_now(void);
+extern void profiler_record(profiler_zone_t zone, uint32_t ticks);
+extern void profiler_dump(profiler_output_t out);
+
+#define PROFILE_BEGIN(zone) uint32_t profile_start_##zone = profiler_now()
+#define PROFILE_END(zone) profiler_record(zone, profiler_now() - profile_start_##zone)
+
+#else
+
+#define profiler_init() ((void) 0)
+#define profiler_reset() ((void) 0)
+#define profiler_dump(out) ((void) (out))
+#define PROFILE_BEGIN(zone) do { } while (0)
+#define PROFILE_END(zone) do { } while (0)
+
+#endif /* PROFILER_ENABLED */
+
+#endif /* INC_PROFILER_H_ */
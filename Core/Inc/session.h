@@ -0,0 +1,82 @@
+/*
+ * session.h
+ *
+ * Input recording and replay. A session is the game seed plus, for every
+ * main-loop tick, the held-button mask fed to input_update() and the number
+ * of physics steps the frame scheduler granted. Identical ticks are merged
+ * (run-length), so a tick costs nothing while input and stepping repeat.
+ * A potentiometer position is logged only when it changes, as a marker
+ * entry ahead of the tick that first saw it.
+ * Replaying the ticks from the same seed reproduces the GameState exactly.
+ * The host saves a recording with session_pop(); the firmware streams it to
+ * the debug console with session_export() before the ring can fill.
+ */
+
+#ifndef INC_SESSION_H_
+#define INC_SESSION_H_
+
+/* Includes */
+#include "stdint.h"
+
+/* Defines */
+#define SESSION_LOG_SIZE 1024		// ring entries, 4 bytes each
+#define SESSION_REPEAT_MAX 0x2000	// ticks one entry can stand for
+#define SESSION_EXPORT_LINE 8		// entries per session_export() line
+
+// Entry: buttons[31:16] steps[15:13] (repeat - 1)[12:0]
+typedef uint32_t session_entry_t;
+#define SESSION_ENTRY(buttons, steps, repeat) \
+	(((uint32_t) (buttons) << 16) | ((uint32_t) (steps) << 13) | ((uint32_t) (repeat) - 1))
+#define SESSION_ENTRY_BUTTONS(entry) ((uint16_t) ((entry) >> 16))
+#define SESSION_ENTRY_STEPS(entry) ((uint8_t) (((entry) >> 13) & 0x7))
+#define SESSION_ENTRY_REPEAT(entry) (((entry) & 0x1FFF) + 1)
+
+// Marker entry: steps field SESSION_STEPS_POT, buttons field the position
+#define SESSION_STEPS_POT 7
+#define SESSION_ENTRY_POT(position) SESSION_ENTRY(position, SESSION_STEPS_POT, 1)
+#define SESSION_POT_NONE 0xFFFF		// no position logged yet
+
+/* Types */
+typedef enum {
+	SESSION_OFF,
+	SESSION_RECORDING,
+	SESSION_REPLAYING
+} session_mode_t;
+
+typedef struct {
+	session_mode_t mode;
+	uint32_t seed;					// passed to game_seed() when the session started
+	session_entry_t log[SESSION_LOG_SIZE];
+	uint16_t head;					// next entry written
+	uint16_t tail;					// next entry read
+	uint16_t count;
+	uint32_t dropped;				// entries lost to a full ring; the session no longer replays
+	uint16_t run_buttons;			// run of identical ticks not yet in / taken from the ring
+	uint8_t run_steps;
+	uint16_t run_repeat;			// recording: ticks in the run, replay: ticks left
+	uint16_t tick_buttons;			// tick being recorded
+	uint8_t tick_steps;
+	uint8_t tick_open;
+	uint16_t pot;					// last potentiometer position logged or replayed
+	uint32_t exported;				// entries taken out by session_export()
+} session_t;
+
+typedef void (*session_output_t)(const char *line);
+
+/* Variables */
+extern session_t session;
+
+/* Functions */
+extern void session_record_start(uint32_t seed);
+extern void session_replay_start(uint32_t seed);
+extern void session_stop(void);
+
+extern uint16_t session_buttons(uint16_t live);
+extern uint8_t session_steps(uint8_t live);
+extern uint8_t session_pot(uint8_t live);
+
+extern uint8_t session_push(session_entry_t entry);
+extern uint16_t session_pop(session_entry_t *entries, uint16_t max);
+extern void session_export(session_output_t out, uint16_t min);
+
+#endif /* INC_SESSION_H_ */
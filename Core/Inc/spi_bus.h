@@ -0,0 +1,51 @@
+/*
+ * spi_bus.h
+ *
+ * SPI1 transaction queue shared by the button shift registers and the
+ * 7-segment display. Transfers are queued from any context, run one at a
+ * time by DMA, and the device latch lines are driven around each transfer.
+ */
+
+#ifndef INC_SPI_BUS_H_
+#define INC_SPI_BUS_H_
+
+/* Includes */
+#include "stdint.h"
+
+/* Defines */
+#define SPI_BUS_QUEUE_SIZE 4	// at most one pending transfer per device
+
+/* Types */
+typedef enum {
+	SPI_BUS_BUTTONS,			// 74HC165 chain, BTN_LOAD, receive
+	SPI_BUS_LED_7SEG,			// 74HC595 chain, LD_LATCH, transmit
+	SPI_BUS_DEVICE_COUNT
+} spi_bus_device_t;
+
+// Runs in the DMA interrupt with the received word (transmits: the sent one)
+typedef void (*spi_bus_done_t)(uint16_t word);
+
+typedef struct {
+	uint32_t submitted;
+	uint32_t completed;
+	uint32_t dropped;			// refused: the device already had one pending
+	uint32_t contended;			// had to wait for another device's transfer
+	uint32_t errors;			// DMA start failures and SPI error callbacks
+	uint32_t latency_max;		// ticks, submit to completion
+	uint64_t latency_total;		// ticks
+} spi_bus_stats_t;
+
+// Receives one report line at a time, without a line terminator
+typedef void (*spi_bus_output_t)(const char *line);
+
+/* Variables */
+extern spi_bus_stats_t spi_bus_stats[SPI_BUS_DEVICE_COUNT];
+
+/* Functions */
+extern void spi_bus_init(void);
+extern uint8_t spi_bus_submit(spi_bus_device_t device, uint16_t word,
+		spi_bus_done_t done);
+extern void spi_bus_reset_stats(void);
+extern void spi_bus_dump(spi_bus_output_t out);
+
+#endif /* INC_SPI_BUS_H_ */
@@ -0,0 +1,29 @@
+/*
+ * sprite.h
+ */
+
+#ifndef INC_SPRITE_H_
+#define INC_SPRITE_H_
+
+/* Includes */
+#include <stdint.h>
+
+/* Constants */
+#define SPRITE_MAX_SIZE 17 // fits a ball of radius 8
+
+/* Struct */
+// Pre-rasterized RGB565 bitmap; each row is opaque on [row_start, row_end)
+typedef struct {
+	uint8_t width;
+	uint8_t height;
+	uint16_t pixels[SPRITE_MAX_SIZE * SPRITE_MAX_SIZE];
+	uint8_t row_start[SPRITE_MAX_SIZE];
+	uint8_t row_end[SPRITE_MAX_SIZE];
+} Sprite;
+
+/* Functions */
+uint8_t sprite_build_ball(Sprite *sprite, uint8_t radius, uint16_t color);
+void sprite_blend_row(const Sprite *sprite, int16_t sx, int16_t sy,
+		int16_t x, int16_t y, uint16_t w, uint16_t *row);
+
+#endif /* INC_SPRITE_H_ */
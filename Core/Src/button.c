@@ -1,16 +1,26 @@
 /*
  * button.c
+ *
+ * The 74HC165 chain is read through the SPI1 bus queue, submitted from the
+ * 1 ms timer every BUTTON_SCAN_MS. Each finished read is decoded into a held mask and
+ * published through a double buffer; the main loop takes the newest mask
+ * with button_take() and feeds it to input_update().
  */
 
 /* Includes */
 #include "button.h"
 
-#include "spi.h"
-#include "gpio.h"
+#include "spi_bus.h"
 
 /* Variables */
-uint16_t button_count[16] = { 0 };
-static uint16_t button_spi_buffer = 0x0000;
+uint32_t button_missed = 0;		// scans published but never taken
+uint32_t button_skipped = 0;	// scan slots lost: the previous read still queued
+
+static volatile uint16_t button_snapshot[2];	// written by the SPI callback
+static volatile uint8_t button_front = 0;		// slot holding the newest scan
+static volatile uint32_t button_sequence = 0;	// scans published so far
+static uint32_t button_taken = 0;				// sequence of the last take
+static uint8_t button_timer = 0;
 
 /* Functions */
 /**
@@ -19,20 +29,16 @@ static uint16_t button_spi_buffer = 0x0000;
  * @retval 	None
  */
 void button_init() {
-	HAL_GPIO_WritePin(BTN_LOAD_GPIO_Port, BTN_LOAD_Pin, 1);
+	button_timer = 0;
 }
 
 /**
- * @brief  	Scan matrix button
- * @param  	None
- * @note  	Call every 50ms
- * @retval 	None
+ * @brief  	Decode the shift-register word into held buttons
+ * @param  	word Raw chain word, lines active low
+ * @retval 	Held buttons, bit n set = button n pressed
  */
-void button_scan() {
-	HAL_GPIO_WritePin(BTN_LOAD_GPIO_Port, BTN_LOAD_Pin, 0);
-	HAL_GPIO_WritePin(BTN_LOAD_GPIO_Port, BTN_LOAD_Pin, 1);
-	HAL_SPI_Receive(&hspi1, (void*) &button_spi_buffer, 2, 10);
-
+static uint16_t button_decode(uint16_t word) {
+	uint16_t held = 0;
 	int button_index = 0;
 	uint16_t mask = 0x8000;
 	for (int i = 0; i < 16; i++) {
@@ -45,11 +51,55 @@ void button_scan() {
 		} else {
 			button_index = 23 - i;
 		}
-		if (button_spi_buffer & mask)
-			button_count[button_index] = 0;
-		else
-			button_count[button_index]++;
+		if (!(word & mask))
+			held |= 1u << button_index;
 		mask = mask >> 1;
 	}
+	return held;
+}
+
+/**
+ * @brief  	Shift-register read finished: publish the scan in the back slot
+ * @param  	word Raw chain word
+ * @note  	Runs in the SPI1 DMA interrupt
+ * @retval 	None
+ */
+static void button_spi_done(uint16_t word) {
+	uint8_t back = button_front ^ 1;
+	button_snapshot[back] = button_decode(word);
+	button_front = back;
+	button_sequence++;
 }
 
+/**
+ * @brief  	Start a shift-register read every BUTTON_SCAN_MS
+ * @param  	None
+ * @note  	Call from the 1 ms timer interrupt
+ * @retval 	None
+ */
+void button_timer_tick() {
+	if (++button_timer < BUTTON_SCAN_MS)
+		return;
+	button_timer = 0;
+	if (!spi_bus_submit(SPI_BUS_BUTTONS, 0, button_spi_done))
+		button_skipped++;
+}
+
+/**
+ * @brief  	Take the newest scan, if one arrived since the last call
+ * @param  	held Receives the held buttons
+ * @retval 	1 if a new scan was taken, 0 otherwise
+ */
+uint8_t button_take(uint16_t *held) {
+	uint32_t sequence;
+	do {
+		// A scan finishing mid-read may reuse the slot: read again
+		sequence = button_sequence;
+		*held = button_snapshot[button_front];
+	} while (sequence != button_sequence);
+	if (sequence == button_taken)
+		return 0;
+	button_missed += sequence - button_taken - 1;
+	button_taken = sequence;
+	return 1;
+}
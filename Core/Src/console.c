@@ -0,0 +1,94 @@
+/*
+ * console.c
+ *
+ * USART1 is set up on registers: the project does not carry the HAL UART
+ * driver, and the console only ever transmits. SWO is not an option on this
+ * board because PB3 is SPI1_SCK.
+ */
+
+/* Includes */
+#include "console.h"
+#include "main.h"
+
+#define CONSOLE_LOCK() uint32_t console_primask = __get_PRIMASK(); __disable_irq()
+#define CONSOLE_UNLOCK() __set_PRIMASK(console_primask)
+
+/* Variables */
+uint32_t console_waits = 0;
+
+static char console_ring[CONSOLE_TX_SIZE];
+static uint16_t console_head = 0;
+static volatile uint16_t console_count = 0;
+
+/* Functions */
+/**
+ * @brief  	Route PA9 to USART1 TX and enable the transmitter
+ * @param  	None
+ * @note  	Call after SystemClock_Config(): the baud rate follows PCLK2
+ * @retval 	None
+ */
+void console_init(void) {
+	__HAL_RCC_GPIOA_CLK_ENABLE();
+	__HAL_RCC_USART1_CLK_ENABLE();
+
+	GPIO_InitTypeDef GPIO_InitStruct = { 0 };
+	GPIO_InitStruct.Pin = GPIO_PIN_9;
+	GPIO_InitStruct.Mode = GPIO_MODE_AF_PP;
+	GPIO_InitStruct.Pull = GPIO_PULLUP;
+	GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_VERY_HIGH;
+	GPIO_InitStruct.Alternate = GPIO_AF7_USART1;
+	HAL_GPIO_Init(GPIOA, &GPIO_InitStruct);
+
+	// 16x oversampling: BRR is PCLK2 / baud with 4 fraction bits
+	USART1->BRR = (HAL_RCC_GetPCLK2Freq() + CONSOLE_BAUD / 2) / CONSOLE_BAUD;
+	USART1->CR1 = USART_CR1_UE | USART_CR1_TE;
+
+	// Below the timer, SPI and ADC interrupts: the console can always wait
+	HAL_NVIC_SetPriority(USART1_IRQn, 1, 0);
+	HAL_NVIC_EnableIRQ(USART1_IRQn);
+}
+
+/**
+ * @brief  	Free bytes in the transmit ring
+ * @param  	None
+ * @retval 	Characters console_putc() takes without waiting
+ */
+uint16_t console_room(void) {
+	return CONSOLE_TX_SIZE - console_count;
+}
+
+/**
+ * @brief  	Queue one character for transmission
+ * @param  	c Character
+ * @note  	Waits for room when the ring is full; call from thread mode only
+ * @retval 	None
+ */
+void console_putc(char c) {
+	if (console_count == CONSOLE_TX_SIZE) {
+		console_waits++;
+		while (console_count == CONSOLE_TX_SIZE) {
+		}
+	}
+	CONSOLE_LOCK();
+	console_ring[(console_head + console_count) % CONSOLE_TX_SIZE] = c;
+	console_count++;
+	USART1->CR1 |= USART_CR1_TXEIE;
+	CONSOLE_UNLOCK();
+}
+
+/**
+ * @brief  	Feed the transmit register; call from USART1_IRQHandler
+ * @param  	None
+ * @retval 	None
+ */
+void console_irq(void) {
+	if (!(USART1->SR & USART_SR_TXE))
+		return;
+	if (console_count == 0) {
+		USART1->CR1 &= ~USART_CR1_TXEIE;
+		return;
+	}
+	USART1->DR = (uint8_t) console_ring[console_head];
+	console_head = (console_head + 1) % CONSOLE_TX_SIZE;
+	console_count--;
+}
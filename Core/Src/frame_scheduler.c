@@ -0,0 +1,68 @@
+/*
+ * frame_scheduler.c
+ *
+ * Fixed-timestep scheduling: simulation time follows HAL_GetTick() no matter
+ * how long rendering takes, and the screen is drawn once per batch of steps.
+ */
+
+/* Includes */
+#include "frame_scheduler.h"
+#include "main.h"
+
+/* Variables */
+frame_scheduler_t frame_scheduler;
+
+/* Functions */
+/**
+ * @brief  	Clear the statistics and start owing time from now
+ * @param  	None
+ * @retval 	None
+ */
+void frame_scheduler_init(void) {
+	frame_scheduler.frames = 0;
+	frame_scheduler.steps = 0;
+	frame_scheduler.skipped = 0;
+	frame_scheduler.overruns = 0;
+	frame_scheduler.dropped_ms = 0;
+	frame_scheduler_resync();
+}
+
+/**
+ * @brief  	Forget time owed so far, e.g. after a pause or a prompt
+ * @param  	None
+ * @retval 	None
+ */
+void frame_scheduler_resync(void) {
+	frame_scheduler.last_tick = HAL_GetTick();
+	frame_scheduler.accumulator = 0;
+}
+
+/**
+ * @brief  	Number of FRAME_STEP_MS physics steps due now
+ * @param  	None
+ * @note	Call once per main loop pass. When it returns n > 0, run n steps
+ * 			then render once. Past FRAME_MAX_SUBSTEPS the rest of the owed
+ * 			time is dropped so a long stall cannot snowball.
+ * @retval 	Steps to run, 0 if the next step is not due yet
+ */
+uint8_t frame_scheduler_poll(void) {
+	uint32_t now = HAL_GetTick();
+	uint32_t steps;
+
+	frame_scheduler.accumulator += now - frame_scheduler.last_tick;
+	frame_scheduler.last_tick = now;
+	if (frame_scheduler.accumulator < FRAME_STEP_MS)
+		return 0;
+
+	steps = frame_scheduler.accumulator / FRAME_STEP_MS;
+	frame_scheduler.accumulator -= steps * FRAME_STEP_MS;
+	if (steps > FRAME_MAX_SUBSTEPS) {
+		frame_scheduler.overruns++;
+		frame_scheduler.dropped_ms += (steps - FRAME_MAX_SUBSTEPS) * FRAME_STEP_MS;
+		steps = FRAME_MAX_SUBSTEPS;
+	}
+	frame_scheduler.frames++;
+	frame_scheduler.steps += steps;
+	frame_scheduler.skipped += steps - 1;
+	return (uint8_t) steps;
+}
@@ -1,5 +1,4 @@
 #include "game_logic.h"
-#include <math.h>
 #include <stdio.h>
 #include <stdint.h>
 uint8_t circle_aabb_overlap(int16_t cx, int16_t cy, uint16_t radius,
@@ -28,7 +27,9 @@ uint8_t resolve_ball_brick(Ball *ball, Brick *brick) {
         return 0; // Brick is still above game area
     }
 
-    if (!circle_aabb_overlap(ball->x, ball->y, ball->radius,
+    int16_t bx = BALL_PX(ball);
+    int16_t by = BALL_PY(ball);
+    if (!circle_aabb_overlap(bx, by, ball->radius,
                              brick->x, brick->y,
                              brick->width, brick->height)) {
         return 0; // No collision
@@ -36,50 +37,87 @@ uint8_t resolve_ball_brick(Ball *ball, Brick *brick) {
     /*
     * Check the side of collision and adjust ball velocity accordingly: vertical or horizontal or corner
     */
-    uint8_t overlapL = ball->x + ball->radius - brick->x;
-    uint8_t overlapR = (brick->x + brick->width) - (ball->x - ball->radius);
-    uint8_t overlapT = ball->y + ball->radius - brick->y;
-    uint8_t overlapB = (brick->y + brick->height) - (ball->y - ball->radius);
+    uint8_t overlapL = bx + ball->radius - brick->x;
+    uint8_t overlapR = (brick->x + brick->width) - (bx - ball->radius);
+    uint8_t overlapT = by + ball->radius - brick->y;
+    uint8_t overlapB = (brick->y + brick->height) - (by - ball->radius);
     uint8_t minOverlapX = (overlapL < overlapR) ? overlapL : overlapR;
     uint8_t minOverlapY = (overlapT < overlapB) ? overlapT : overlapB;
 
-    float crit45 = fmaxf(CRIT45_FLOOR, ball->radius * CRIT45_SCALE);
-    if (fabsf(minOverlapX - minOverlapY) <= crit45) {
+    fix16_t crit45 = ball->radius * CRIT45_SCALE;
+    if (crit45 < CRIT45_FLOOR) crit45 = CRIT45_FLOOR;
+    if (fix16_abs(FIX16_FROM_INT(minOverlapX - minOverlapY)) <= crit45) {
         // Corner collision
         ball->dx = -ball->dx;
         ball->dy = -ball->dy;
         // Nudge ball out of collision
-        ball->x += (overlapL < overlapR) ? -1 : 1;
-        ball->y += (overlapT < overlapB) ? -1 : 1;
+        ball->x += (overlapL < overlapR) ? -FIX16_ONE : FIX16_ONE;
+        ball->y += (overlapT < overlapB) ? -FIX16_ONE : FIX16_ONE;
     } else if (minOverlapX < minOverlapY) {
         // Vertical collision
         ball->dx = -ball->dx;
-        ball->x = (overlapL < overlapR) ? (brick->x - ball->radius) : (brick->x + brick->width + ball->radius);
+        ball->x = FIX16_FROM_INT((overlapL < overlapR) ? (brick->x - ball->radius) : (brick->x + brick->width + ball->radius));
     } else {
         // Horizontal collision
         ball->dy = -ball->dy;
-        ball->y = (overlapT < overlapB) ? (brick->y - ball->radius) : (brick->y + brick->height + ball->radius);
+        ball->y = FIX16_FROM_INT((overlapT < overlapB) ? (brick->y - ball->radius) : (brick->y + brick->height + ball->radius));
     }
     brick->state = BRICK_STATE_DESTROYED;
     return 1; // Collision occurred
 }
 
+/**
+ * @brief Samples the paddle position once per step and updates its
+ * smoothed velocity. Works the same whether the buttons or the
+ * potentiometer moved it. One integer division per step.
+ */
+void game_track_paddle(Paddle *paddle, fix16_t dt) {
+    int32_t dx = (int32_t)paddle->x - paddle->sample_x;
+    paddle->sample_x = paddle->x;
+    // px per step -> px/s in Q16.16
+    fix16_t raw = (fix16_t)(((int64_t)dx << (2 * FIX16_SHIFT)) / dt);
+    raw = CLAMP(raw, -FIX16_FROM_INT(PADDLE_V_MAX), FIX16_FROM_INT(PADDLE_V_MAX));
+    // Divide, not shift: the step rounds toward zero for either direction,
+    // and once it is zero the velocity settles on raw instead of stalling
+    // one unit short of it
+    fix16_t step = (raw - paddle->velocity) / (1 << PADDLE_V_SHIFT);
+    paddle->velocity = step != 0 ? paddle->velocity + step : raw;
+}
+
+/**
+ * @brief Adds the paddle's motion to a rebounding ball: a moving paddle
+ * drags the ball along by K_SPIN of its velocity, within +-V_X_MAX.
+ */
+void apply_spin_to_ball(Ball *ball, fix16_t paddle_velocity) {
+    fix16_t dx = ball->dx + fix16_mul(K_SPIN_FIX, paddle_velocity);
+    ball->dx = CLAMP(dx, -FIX16_FROM_INT(V_X_MAX), FIX16_FROM_INT(V_X_MAX));
+}
+
+/**
+ * @brief Sends the ball back up, angled by where it met the paddle and
+ * dragged by how the paddle was moving.
+ */
+static void paddle_bounce(Ball *ball, const Paddle *paddle) {
+    // Simple reflection logic
+    ball->dy = -fix16_abs(ball->dy); // Always reflect upwards
+
+    // Adjust horizontal velocity based on where it hit the paddle:
+    // -V_X_MAX at the left end, +V_X_MAX at the right end
+    ball->dx = fix16_from_ratio((2 * (BALL_PX(ball) - paddle->x) - paddle->width) * V_X_MAX, paddle->width);
+    apply_spin_to_ball(ball, paddle->velocity);
+}
+
 uint8_t resolve_ball_paddle(Ball *ball, const Paddle *paddle) {
-    if (!circle_aabb_overlap(ball->x, ball->y, ball->radius,
+    if (!circle_aabb_overlap(BALL_PX(ball), BALL_PY(ball), ball->radius,
                              paddle->x, paddle->y,
                              paddle->width, paddle->height)) {
         return 0; // No collision
     }
 
-    // Simple reflection logic
-    ball->dy = -fabsf(ball->dy); // Always reflect upwards
-
-    // Adjust horizontal velocity based on where it hit the paddle
-    float hitPos = (float)(ball->x - paddle->x) / (float)paddle->width; // 0.0 (left) to 1.0 (right)
-    ball->dx = (hitPos - 0.5f) * 2.0f * V_X_MAX; // Scale to max horizontal speed
+    paddle_bounce(ball, paddle);
 
     // Clamp ball position to be just above the paddle
-    ball->y = paddle->y - ball->radius - 1;
+    ball->y = FIX16_FROM_INT(paddle->y - ball->radius - 1);
 
     return 1; // Collision occurred
 }
@@ -90,26 +128,29 @@ uint8_t resolve_ball_wall(Ball *ball) {
     // collided = 1: wall collision
     // collided = 2: out of bounds (bottom)
 
+    int16_t bx = BALL_PX(ball);
+    int16_t by = BALL_PY(ball);
+
     // Left wall
-    if (ball->x - ball->radius <= 0) {
-        ball->dx = fabsf(ball->dx);
-        ball->x = ball->radius + 1;
+    if (bx - ball->radius <= 0) {
+        ball->dx = fix16_abs(ball->dx);
+        ball->x = FIX16_FROM_INT(ball->radius + 1);
         collided = 1;
     }
     // Right wall
-    else if (ball->x + ball->radius >= SCREEN_WIDTH - 1) {
-        ball->dx = -fabsf(ball->dx);
-        ball->x = SCREEN_WIDTH - ball->radius - 1;
+    else if (bx + ball->radius >= SCREEN_WIDTH - 1) {
+        ball->dx = -fix16_abs(ball->dx);
+        ball->x = FIX16_FROM_INT(SCREEN_WIDTH - ball->radius - 1);
         collided = 1;
     }
     // Top wall
-    if (ball->y - ball->radius <= UI_BAR_HEIGHT) {
-        ball->dy = fabsf(ball->dy);
-        ball->y = UI_BAR_HEIGHT + ball->radius + 1;
+    if (by - ball->radius <= UI_BAR_HEIGHT) {
+        ball->dy = fix16_abs(ball->dy);
+        ball->y = FIX16_FROM_INT(UI_BAR_HEIGHT + ball->radius + 1);
         collided = 1;
     }
     // Bottom wall (missed paddle)
-    else if (ball->y + ball->radius >= SCREEN_HEIGHT - 1) {
+    else if (by + ball->radius >= SCREEN_HEIGHT - 1) {
         // Ball is out of bounds, typically handled as a life lost
         collided = 2; // Indicate out of bounds
     }
@@ -119,22 +160,320 @@ uint8_t resolve_ball_wall(Ball *ball) {
 
 void initialize_ball_velocity(Ball *ball) {
     // Start with a fixed angle upwards
-    ball->dx = 0.0f;
-    ball->dy = -V_MIN;
+    ball->dx = 0;
+    ball->dy = FIX16_FROM_INT(-V_MIN);
+}
+
+/**
+ * @brief Grid cells [first, last] along one axis that the pixel interval
+ * [lo, hi] can touch. Returns 0 when the interval misses the grid.
+ */
+static uint8_t grid_cell_range(int16_t lo, int16_t hi, int16_t origin,
+                               int16_t pitch, int16_t count,
+                               int16_t *first, int16_t *last) {
+    lo -= origin;
+    hi -= origin;
+    if (hi < 0 || lo >= count * pitch) return 0;
+    *first = lo < 0 ? 0 : lo / pitch;
+    *last = hi / pitch;
+    if (*last >= count) *last = count - 1;
+    return 1;
+}
+
+/**
+ * @brief Brick cells the pixel box [x1, x2] x [y1, y2] can touch: rows
+ * [*row0, *row1] (empty when *row1 < *row0), columns as the returned mask.
+ */
+static uint32_t grid_cells(const GameState *state, int16_t x1, int16_t y1,
+                           int16_t x2, int16_t y2, int16_t *row0, int16_t *row1) {
+    int16_t col0, col1;
+    *row0 = 0;
+    *row1 = -1;
+    if (!grid_cell_range(x1, x2, GRID_PADDING_X, BRICK_PITCH_X, BRICK_COLS, &col0, &col1) ||
+        !grid_cell_range(y1, y2, GRID_START_Y + state->brick_drop_offset,
+                         BRICK_PITCH_Y, BRICK_ROWS, row0, row1)) {
+        return 0;
+    }
+    return (BRICK_ROW_MASK >> (BRICK_COLS - 1 - col1)) & (BRICK_ROW_MASK << col0);
+}
+
+/**
+ * @brief Queues an event for the renderer. When the ring is full the event
+ * is dropped and the queue flagged, so the next drain redraws everything.
+ */
+void game_push_event(GameState *state, const GameEvent *event) {
+    GameEventQueue *q = &state->events;
+    if (q->count == GAME_EVENT_QUEUE_SIZE) {
+        q->overflow = 1;
+        return;
+    }
+    q->events[(q->head + q->count) % GAME_EVENT_QUEUE_SIZE] = *event;
+    q->count++;
+}
+
+/**
+ * @brief Takes the oldest queued event. Returns 0 when the queue is empty.
+ */
+uint8_t game_pop_event(GameState *state, GameEvent *event) {
+    GameEventQueue *q = &state->events;
+    if (q->count == 0) return 0;
+    *event = q->events[q->head];
+    q->head = (q->head + 1) % GAME_EVENT_QUEUE_SIZE;
+    q->count--;
+    return 1;
+}
+
+static void push_simple_event(GameState *state, GameEventType type) {
+    GameEvent event = { .type = type };
+    game_push_event(state, &event);
+}
+
+/**
+ * @brief Books a brick the ball just destroyed: liveness, score, an event
+ * for the screen and its special effect.
+ */
+static void destroy_brick(GameState *state, Ball *ball, int row, int col) {
+    Brick *brick = &state->bricks[row][col];
+    brick->state = BRICK_STATE_DESTROYED;
+    state->brick_alive[row] &= ~(1UL << col);
+    state->bricks_left--;
+    GameEvent event = { .type = GAME_EVENT_BRICK_DESTROYED, .row = row, .col = col };
+    game_push_event(state, &event);
+    state->score += 10;
+    // special handling:
+    if (brick->special == BRICK_SPECIAL_BALL) {
+        spawn_extra_ball(state, ball);
+    } else if (brick->special == BRICK_SPECIAL_PLUS) {
+        apply_plus_powerup(state);
+    }
+}
+
+// --- Swept collision ---
+
+// Contacts resolved per ball and step before the rest of the move is
+// applied unchecked
+#define SWEEP_MAX_HITS 4
+// Velocity components a contact reflects
+#define SWEEP_AXIS_X 1
+#define SWEEP_AXIS_Y 2
+
+/**
+ * @brief Integer square root, rounded down.
+ */
+static uint32_t isqrt64(uint64_t v) {
+    uint64_t root = 0;
+    uint64_t bit = 1ULL << 62;
+    while (bit > v) bit >>= 2;
+    while (bit != 0) {
+        if (v >= root + bit) {
+            v -= root + bit;
+            root = (root >> 1) + bit;
+        } else {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+    return (uint32_t)root;
+}
+
+/**
+ * @brief Time of impact num / m as a fraction of the move, saturated to
+ * the fix16_t range: a near-zero m means the contact is far outside the
+ * step, never a wrapped value inside it.
+ */
+static fix16_t sweep_time(int64_t num, int64_t m) {
+    int64_t t = num * FIX16_ONE / m;
+    if (t > INT32_MAX) return INT32_MAX;
+    if (t < INT32_MIN) return INT32_MIN;
+    return (fix16_t)t;
 }
 
-void step_world(GameState *state, float dt) {
+/**
+ * @brief Slab entry/exit times of a moving coordinate p + m*t against the
+ * open interval (lo, hi). Returns 0 if it is never inside for any t.
+ */
+static uint8_t sweep_slab(fix16_t p, fix16_t m, fix16_t lo, fix16_t hi,
+                          fix16_t *t_in, fix16_t *t_out) {
+    if (m == 0) {
+        if (p <= lo || p >= hi) return 0;
+        *t_in = INT32_MIN;
+        *t_out = INT32_MAX;
+        return 1;
+    }
+    fix16_t near = m > 0 ? lo : hi;
+    fix16_t far = m > 0 ? hi : lo;
+    *t_in = sweep_time((int64_t)near - p, m);
+    *t_out = sweep_time((int64_t)far - p, m);
+    return 1;
+}
+
+/**
+ * @brief First contact of a circle of radius r moving from (px, py) by
+ * (mx, my) with the closed rectangle [x1, x2] x [y1, y2].
+ * @param t Time of impact as a fraction of the move; only hits sooner
+ *        than the value passed in are reported
+ * @param axis SWEEP_AXIS_X / SWEEP_AXIS_Y: velocity components to reflect
+ * @retval 1 on a hit, 0 if the circle misses or starts out overlapping
+ * (overlaps are left to the end-of-step resolution)
+ */
+static uint8_t sweep_circle_rect(fix16_t px, fix16_t py, fix16_t mx, fix16_t my,
+                                 uint8_t r, int16_t x1, int16_t y1,
+                                 int16_t x2, int16_t y2,
+                                 fix16_t *t, uint8_t *axis) {
+    fix16_t fr = FIX16_FROM_INT(r);
+    fix16_t tx_in, tx_out, ty_in, ty_out;
+
+    // Slabs of the rectangle grown by r; exact except in the corners
+    if (!sweep_slab(px, mx, FIX16_FROM_INT(x1) - fr, FIX16_FROM_INT(x2) + fr, &tx_in, &tx_out) ||
+        !sweep_slab(py, my, FIX16_FROM_INT(y1) - fr, FIX16_FROM_INT(y2) + fr, &ty_in, &ty_out)) {
+        return 0;
+    }
+    fix16_t t_in = tx_in > ty_in ? tx_in : ty_in;
+    fix16_t t_out = tx_out < ty_out ? tx_out : ty_out;
+    if (t_in < 0 || t_in >= t_out || t_in >= *t) return 0;
+
+    fix16_t hx = px + fix16_mul(mx, t_in);
+    fix16_t hy = py + fix16_mul(my, t_in);
+    uint8_t in_x = hx >= FIX16_FROM_INT(x1) && hx <= FIX16_FROM_INT(x2);
+    uint8_t in_y = hy >= FIX16_FROM_INT(y1) && hy <= FIX16_FROM_INT(y2);
+    if (in_x || in_y) {
+        // Flat side: reflect the axis whose slab was entered last
+        *t = t_in;
+        *axis = in_y ? SWEEP_AXIS_X : SWEEP_AXIS_Y;
+        if (in_x && in_y) *axis = SWEEP_AXIS_X | SWEEP_AXIS_Y;
+        return 1;
+    }
+
+    // Corner region: solve |P + M t - C| = r against the corner point C,
+    // in 1/256 pixel units so the squares fit in 64 bits
+    fix16_t cx = FIX16_FROM_INT(hx < FIX16_FROM_INT(x1) ? x1 : x2);
+    fix16_t cy = FIX16_FROM_INT(hy < FIX16_FROM_INT(y1) ? y1 : y2);
+    int64_t ox = (px - cx) >> 8, oy = (py - cy) >> 8;
+    int64_t vx = mx >> 8, vy = my >> 8;
+    int64_t a = vx * vx + vy * vy;
+    int64_t b = ox * vx + oy * vy;
+    int64_t c = ox * ox + oy * oy - ((int64_t)r * r << 16);
+    if (a == 0 || b >= 0 || c < 0) return 0; // moving away, or overlapping
+    int64_t disc = b * b - a * c;
+    if (disc < 0) return 0; // passes the corner
+    fix16_t tc = sweep_time(-b - (int64_t)isqrt64((uint64_t)disc), a);
+    if (tc < 0 || tc >= *t || tc > FIX16_ONE) return 0;
+    *t = tc;
+    // Reflect the components that carry the ball into the corner
+    hx = px + fix16_mul(mx, tc);
+    hy = py + fix16_mul(my, tc);
+    *axis = 0;
+    if ((cx > hx) == (mx > 0) && mx != 0) *axis |= SWEEP_AXIS_X;
+    if ((cy > hy) == (my > 0) && my != 0) *axis |= SWEEP_AXIS_Y;
+    return 1;
+}
+
+/**
+ * @brief Contact with a wall line the ball center must not cross.
+ */
+static uint8_t sweep_wall(fix16_t p, fix16_t m, fix16_t plane, fix16_t *t) {
+    if (!((m < 0 && p > plane) || (m > 0 && p < plane))) return 0;
+    fix16_t tw = sweep_time((int64_t)plane - p, m);
+    if (tw < 0 || tw >= *t) return 0;
+    *t = tw;
+    return 1;
+}
+
+/**
+ * @brief Moves a ball through one step, bouncing off walls, the paddle and
+ * bricks at their time of impact, so a fast ball cannot pass through them.
+ * Up to SWEEP_MAX_HITS contacts are resolved; the rest of the move is
+ * then applied unchecked and left to the end-of-step resolution.
+ */
+static void sweep_ball(GameState *state, Ball *b, fix16_t dt) {
+    const Paddle *paddle = &state->paddle;
+    fix16_t left = FIX16_FROM_INT(b->radius + 1);
+    fix16_t right = FIX16_FROM_INT(SCREEN_WIDTH - b->radius - 1);
+    fix16_t top = FIX16_FROM_INT(UI_BAR_HEIGHT + b->radius + 1);
+
+    for (uint8_t hits = 0; hits < SWEEP_MAX_HITS; hits++) {
+        fix16_t mx = fix16_mul(b->dx, dt);
+        fix16_t my = fix16_mul(b->dy, dt);
+        fix16_t t = FIX16_ONE + 1; // nothing hit within the move
+        uint8_t axis = 0;
+        int16_t hit_row = -1, hit_col = 0;
+        uint8_t hit_paddle = 0;
+
+        if (sweep_wall(b->x, mx, left, &t) || sweep_wall(b->x, mx, right, &t)) axis = SWEEP_AXIS_X;
+        if (sweep_wall(b->y, my, top, &t)) axis = SWEEP_AXIS_Y;
+
+        if (sweep_circle_rect(b->x, b->y, mx, my, b->radius,
+                              paddle->x, paddle->y, paddle->x + paddle->width,
+                              paddle->y + paddle->height, &t, &axis)) {
+            hit_paddle = 1;
+        }
+
+        // Bricks under the box the ball sweeps through
+        fix16_t ex = b->x + mx, ey = b->y + my;
+        int16_t row0, row1;
+        uint32_t cols = grid_cells(state,
+                FIX16_TO_INT(b->x < ex ? b->x : ex) - b->radius,
+                FIX16_TO_INT(b->y < ey ? b->y : ey) - b->radius,
+                FIX16_TO_INT(b->x > ex ? b->x : ex) + b->radius + 1,
+                FIX16_TO_INT(b->y > ey ? b->y : ey) + b->radius + 1,
+                &row0, &row1);
+        for (int row = row0; row <= row1; row++) {
+            uint32_t live = state->brick_alive[row] & cols;
+            while (live != 0) {
+                int col = __builtin_ctz(live);
+                live &= live - 1;
+                const Brick *brick = &state->bricks[row][col];
+                if (brick->y + brick->height <= UI_BAR_HEIGHT) continue; // not in play yet
+                if (sweep_circle_rect(b->x, b->y, mx, my, b->radius,
+                                      brick->x, brick->y, brick->x + brick->width,
+                                      brick->y + brick->height, &t, &axis)) {
+                    hit_row = row;
+                    hit_col = col;
+                    hit_paddle = 0;
+                }
+            }
+        }
+
+        if (t > FIX16_ONE) break;
+
+        // Move to the contact point and spend that part of the step
+        b->x += fix16_mul(mx, t);
+        b->y += fix16_mul(my, t);
+        dt -= fix16_mul(dt, t);
+        if (hit_paddle) {
+            paddle_bounce(b, paddle);
+        } else {
+            if (axis & SWEEP_AXIS_X) b->dx = -b->dx;
+            if (axis & SWEEP_AXIS_Y) b->dy = -b->dy;
+            if (hit_row >= 0) destroy_brick(state, b, hit_row, hit_col);
+        }
+    }
+    b->x += fix16_mul(b->dx, dt);
+    b->y += fix16_mul(b->dy, dt);
+}
+
+/**
+ * @brief Advances the game by dt seconds (Q16.16).
+ */
+void step_world(GameState *state, fix16_t dt) {
+    game_advance_drop(state);
+    game_track_paddle(&state->paddle, dt); // after this step's input moved it
+
     // update all balls; be careful khi xóa ball trong vòng lặp
     for (int i = 0; i < state->ball_count; ) {
         Ball *b = &state->balls[i];
-        b->x += b->dx * dt;
-        b->y += b->dy * dt;
+        sweep_ball(state, b, dt);
 
+        // End-of-step resolution: catches what the sweep could not, such
+        // as bricks dropping onto a ball or a ball starting in overlap
         uint8_t wc = resolve_ball_wall(b);
         if (wc == 2) { // out of bounds
             // Remove this ball from array (swap-with-last)
-        	game_update_ball(b);
-            game_erase_ball(b);
+            GameEvent event = { .type = GAME_EVENT_BALL_LOST, .radius = b->radius,
+                                .x = BALL_PX(b), .y = BALL_PY(b),
+                                .prev_x = b->prev_x, .prev_y = b->prev_y };
+            game_push_event(state, &event);
+            state->balls_lost++;
             state->balls[i] = state->balls[state->ball_count - 1];
             state->ball_count--;
             continue; // do not increment i, process new occupant
@@ -145,19 +484,19 @@ void step_world(GameState *state, float dt) {
             // paddle collision
             resolve_ball_paddle(b, &state->paddle);
 
-            // brick collisions: iterate bricks and call resolve_ball_brick(b, brick)
-            for (int row = 0; row < BRICK_ROWS; row++) {
-                for (int col = 0; col < BRICK_COLS; col++) {
-                    Brick *brick = &state->bricks[row][col];
-                    if (resolve_ball_brick(b, brick)) {
-                        game_erase_brick(brick);
-                        state->score += 10;
-                        // special handling:
-                        if (brick->special == BRICK_SPECIAL_BALL) {
-                            spawn_extra_ball(state, b);
-                        } else if (brick->special == BRICK_SPECIAL_PLUS) {
-                            apply_plus_powerup(state);
-                        }
+            // brick collisions: only the grid cells under the ball's bounding box
+            int16_t bx = BALL_PX(b), by = BALL_PY(b);
+            int16_t row0, row1;
+            uint32_t cols = grid_cells(state, bx - b->radius, by - b->radius,
+                                       bx + b->radius, by + b->radius, &row0, &row1);
+            for (int row = row0; row <= row1; row++) {
+                // Visit live bricks only, lowest column first
+                uint32_t live = state->brick_alive[row] & cols;
+                while (live != 0) {
+                    int col = __builtin_ctz(live);
+                    live &= live - 1;
+                    if (resolve_ball_brick(b, &state->bricks[row][col])) {
+                        destroy_brick(state, b, row, col);
                     }
                 }
             }
@@ -166,17 +505,12 @@ void step_world(GameState *state, float dt) {
     }
 
     // After loop: check if all bricks destroyed -> advance level
-    int active_bricks = 0;
-    for (int row = 0; row < BRICK_ROWS; row++) {
-        for (int col = 0; col < BRICK_COLS; col++) {
-            if (state->bricks[row][col].state == BRICK_STATE_ACTIVE) active_bricks++;
-        }
-    }
-    if (active_bricks == 0) {
+    // (bricks still dropping in count as remaining)
+    if (state->bricks_left == 0) {
         // advance to next level
         advance_level(state);
-        // redraw initial scene to show new bricks
-        game_draw_initial_scene(state);
+        // the renderer redraws the scene to show the new bricks
+        push_simple_event(state, GAME_EVENT_LEVEL_ADVANCED);
         return; // skip life-check this frame
     }
 
@@ -185,17 +519,17 @@ void step_world(GameState *state, float dt) {
         state->lives--;
         if (state->lives == 0) {
             state->status = GAME_OVER;
-            game_draw_game_over_screen(state);
+            push_simple_event(state, GAME_EVENT_GAME_OVER);
             return;
         } else {
             // reset one ball above paddle and set ball_count = 1
             Ball *b = &state->balls[0];
-            b->x = state->paddle.x + state->paddle.width / 2.0f;
-            b->y = state->paddle.y - b->radius - 1;
-            b->dx = 0; b->dy = -V_MIN;
+            b->x = FIX16_FROM_INT(state->paddle.x) + FIX16_FROM_INT(state->paddle.width) / 2;
+            b->y = FIX16_FROM_INT(state->paddle.y - b->radius - 1);
+            b->dx = 0; b->dy = FIX16_FROM_INT(-V_MIN);
             state->ball_count = 1;
             state->show_potentiometer_prompt = 1;
-            game_draw_initial_scene(state);
+            push_simple_event(state, GAME_EVENT_LIFE_LOST);
         }
     }
 }
@@ -4,18 +4,63 @@
 #include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
-#include "button.h"
+#include "input.h"
+#include "potentiometer.h"
+#include "sprite.h"
 
 // --- Private Function Prototypes ---
 static void draw_ui_bar(uint8_t lives, uint32_t score, uint8_t level);
+static uint8_t ui_format_uint(uint32_t value, uint8_t min_digits, char *out);
+static void ui_draw_text(uint16_t x, const char *text, uint8_t len,
+        char *shown, uint8_t redraw_all);
 static void draw_bricks(const GameState *state);
 static void draw_paddle(const Paddle *paddle);
 static void draw_ball(const Ball *ball);
 //static void draw_potentiometer_prompt(void);
-
-// Calculated horizontal padding to center the grid
-#define GRID_PADDING_X ((SCREEN_WIDTH - (BRICK_COLS * BRICK_WIDTH) - ((BRICK_COLS - 1) * BRICK_GAP)) / 2)
-#define GRID_START_Y (UI_BAR_HEIGHT + 20)
+static void render_scene_row(const GameState *state, int16_t x, int16_t y,
+        uint16_t w, uint16_t *row);
+
+// Radius of the outline drawn on BRICK_SPECIAL_BALL bricks
+#define SPECIAL_BALL_RADIUS 6
+
+// --- UI bar cache: what the bar currently shows ---
+#define UI_FONT_SIZE 16
+#define UI_GLYPH_WIDTH (UI_FONT_SIZE / 2)
+#define UI_TEXT_Y 2
+#define UI_SCORE_MIN_DIGITS 5
+#define UI_TEXT_MAX 16 // "LVL:" or up to 10 score digits
+static char ui_score_text[UI_TEXT_MAX];
+static uint8_t ui_score_len;
+static char ui_level_text[UI_TEXT_MAX];
+static uint8_t ui_level_len;
+static uint8_t ui_lives;
+static uint8_t ui_bar_valid = 0; // 0: redraw everything on the next update
+
+// --- Sprite compositing state ---
+static Sprite ball_sprite;
+static uint8_t ball_sprite_radius = 0; // 0: not built yet
+static uint16_t ball_sprite_color;
+static uint32_t special_ball_rows[2 * SPECIAL_BALL_RADIUS + 1];
+static uint8_t special_ball_rows_ready = 0;
+static uint16_t compose_line[SCREEN_WIDTH];
+
+// --- Dirty rectangles (play area, half-open) ---
+#define DIRTY_MAX_RECTS 16
+// Extra pixels a merge may repaint; about the cost of one more address window
+#define DIRTY_MERGE_SLACK 64
+typedef struct {
+    int16_t x1, y1, x2, y2;
+} DirtyRect;
+static DirtyRect dirty_rects[DIRTY_MAX_RECTS];
+static uint8_t dirty_count = 0;
+
+static void compose_box(const GameState *state, const DirtyRect *box);
+
+// --- Retained brick layer: where each brick is on screen right now ---
+static int16_t brick_drawn_y[BRICK_ROWS][BRICK_COLS];
+static uint8_t brick_drawn[BRICK_ROWS][BRICK_COLS]; // 0: nothing on screen
+static void brick_layer_reset(const GameState *state);
+static void brick_layer_sync(const GameState *state);
 
 
 /**
@@ -63,6 +108,8 @@ void game_init_state(GameState *state) {
     state->paddle.y = SCREEN_HEIGHT - state->paddle.height - 5;
     state->paddle.color = WHITE;
     state->paddle.speed = 6; // default paddle movement speed (pixels per update)
+    state->paddle.sample_x = state->paddle.x;
+    state->paddle.velocity = 0;
 
     // 2. Initialize Balls (multi-ball support)
     state->ball_count = 1;
@@ -71,20 +118,25 @@ void game_init_state(GameState *state) {
         state->balls[i].color = WHITE;
     }
     // Initialize first ball
-    state->balls[0].x = state->paddle.x + state->paddle.width / 2.0f;
-    state->balls[0].prev_x = state->balls[0].x;
-    state->balls[0].y = state->paddle.y - state->balls[0].radius - 1;
-    state->balls[0].prev_y = state->balls[0].y;
+    state->balls[0].x = FIX16_FROM_INT(state->paddle.x) + FIX16_FROM_INT(state->paddle.width) / 2;
+    state->balls[0].prev_x = BALL_PX(&state->balls[0]);
+    state->balls[0].y = FIX16_FROM_INT(state->paddle.y - state->balls[0].radius - 1);
+    state->balls[0].prev_y = BALL_PY(&state->balls[0]);
     state->balls[0].dx = 0;  // Initial velocity
-    state->balls[0].dy = -60;
+    state->balls[0].dy = FIX16_FROM_INT(-60);
     state->balls[0].color = WHITE;
 
     // 3. Initialize Score and Lives
     state->score = 0;
     state->lives = MAX_LIVES;
+    state->balls_lost = 0;
+    state->events.head = 0;
+    state->events.count = 0;
+    state->events.overflow = 0;
     state->level = 1;
     state->status = GAME_PLAYING;
     state->show_potentiometer_prompt = 0;
+    state->pot_last = -1;
 
     // Initialize bricks for the starting level without drop animation (animate=0)
     state->level = 1;
@@ -96,11 +148,13 @@ void game_init_state(GameState *state) {
  * This function clears the screen and draws all static and dynamic elements.
  */
 void game_draw_initial_scene(const GameState *state) {
+    dirty_count = 0; // everything is redrawn below
     lcd_clear(BLACK);
     draw_ui_bar(state->lives, state->score, state->level);
-    draw_game_border();
     draw_bricks(state);
+    brick_layer_reset(state);
     draw_paddle(&state->paddle);
+    draw_game_border(); // over bricks clipped by the UI bar and a paddle at the wall
     // Draw all active balls
     for (int i = 0; i < state->ball_count; i++) {
         draw_ball(&state->balls[i]);
@@ -110,71 +164,79 @@ void game_draw_initial_scene(const GameState *state) {
     }
 }
 
+/**
+ * @brief Applies the events the physics steps queued since the last call:
+ * destroyed bricks and lost balls become dirty areas, level and life changes
+ * redraw the scene, game over draws its screen. A queue that overflowed is
+ * settled with a full redraw instead.
+ */
+void game_render_events(GameState *state) {
+    GameEvent event;
+    while (game_pop_event(state, &event)) {
+        switch (event.type) {
+        case GAME_EVENT_BRICK_DESTROYED:
+            game_erase_brick(&state->bricks[event.row][event.col]);
+            break;
+        case GAME_EVENT_BALL_LOST: {
+            Ball ball = { .x = FIX16_FROM_INT(event.x), .y = FIX16_FROM_INT(event.y),
+                          .prev_x = event.prev_x, .prev_y = event.prev_y,
+                          .radius = event.radius };
+            game_erase_ball(&ball);
+            break;
+        }
+        case GAME_EVENT_LEVEL_ADVANCED:
+        case GAME_EVENT_LIFE_LOST:
+            game_draw_initial_scene(state);
+            break;
+        case GAME_EVENT_GAME_OVER:
+            game_draw_game_over_screen(state);
+            break;
+        default:
+            break;
+        }
+    }
+    if (state->events.overflow) {
+        state->events.overflow = 0;
+        if (state->status == GAME_OVER)
+            game_draw_game_over_screen(state);
+        else
+            game_draw_initial_scene(state);
+    }
+}
+
 /**
  * @brief Updates moving objects on the screen efficiently without flickering.
- * Erases objects at their previous positions and redraws them at new positions.
+ * Moving objects mark their old and new areas dirty; only those areas are
+ * recomposed from the scene, so the cost follows motion, not scene size.
+ * Bricks are retained: they are only touched when they move or are destroyed.
  */
 void game_update_screen(GameState *state) {
 	// update components
-    // handle paddle movement from buttons before drawing/updating
-    game_handle_paddle_buttons(state);
 	// Update all active balls
 	for (int i = 0; i < state->ball_count; i++) {
 		game_update_ball(&state->balls[i]);
 	}
     game_update_paddle(&state->paddle);
     game_update_ui_bar(state->score, state->lives, state->level);
-    
-    // Erase INCOMING bricks before updating their position (to avoid visual artifacts)
-    for (int row = 0; row < BRICK_ROWS; row++) {
-        for (int col = 0; col < BRICK_COLS; col++) {
-            Brick *brick = &state->bricks[row][col];
-            if (brick->state == BRICK_STATE_INCOMING) {
-                // Erase old brick position
-                int16_t erase_y1 = brick->y;
-                int16_t erase_y2 = brick->y + brick->height;
-                if (erase_y2 > UI_BAR_HEIGHT && erase_y1 < SCREEN_HEIGHT) {
-                    if (erase_y1 < UI_BAR_HEIGHT) erase_y1 = UI_BAR_HEIGHT;
-                    if (erase_y2 > SCREEN_HEIGHT) erase_y2 = SCREEN_HEIGHT;
-                    lcd_fill(brick->x, erase_y1, brick->x + brick->width, erase_y2, BLACK);
-                }
-            }
-        }
-    }
-    
-    // Update brick drop animation: move bricks from INCOMING state to ACTIVE
-    for (int row = 0; row < BRICK_ROWS; row++) {
-        for (int col = 0; col < BRICK_COLS; col++) {
-            Brick *brick = &state->bricks[row][col];
-            if (brick->state == BRICK_STATE_INCOMING) {
-                brick->y += brick->drop_speed; // Move downward
-                if (brick->y >= brick->final_y) {
-                    brick->y = brick->final_y; // Snap to final position
-                    brick->state = BRICK_STATE_ACTIVE; // Now ready for collision
-                }
-            }
-        }
-    }
-    
-    draw_bricks(state);
-    draw_game_border();
+
+    brick_layer_sync(state);
+
+    game_flush_dirty(state);
     // Update previous positions for the next frame
     state->paddle.prev_x = state->paddle.x;
     for (int i = 0; i < state->ball_count; i++) {
-        state->balls[i].prev_x = state->balls[i].x;
-        state->balls[i].prev_y = state->balls[i].y;
+        state->balls[i].prev_x = BALL_PX(&state->balls[i]);
+        state->balls[i].prev_y = BALL_PY(&state->balls[i]);
     }
 }
 
 /**
- * @brief Update paddle position from two buttons: button_count[5] (left) and button_count[6] (right).
+ * @brief Update paddle position from two buttons: 8 (left) and 9 (right).
  *        Holding a button moves the paddle continuously; the movement is clamped to screen bounds.
  */
 void game_handle_paddle_buttons(GameState *state) {
-    // button_count is updated by button_scan(); >0 means button is pressed
-    extern uint16_t button_count[16];
-
-    if (button_count[8] > 0) {
+    // Debounced levels from input_update()
+    if (input_held(8)) {
         // move left
         if (state->paddle.x > state->paddle.speed)
             state->paddle.x -= state->paddle.speed;
@@ -182,7 +244,7 @@ void game_handle_paddle_buttons(GameState *state) {
             state->paddle.x = 0;
     }
 
-    if (button_count[9] > 0) {
+    if (input_held(9)) {
         // move right
         uint16_t max_x = SCREEN_WIDTH - state->paddle.width;
         if (state->paddle.x + state->paddle.speed < max_x)
@@ -194,6 +256,26 @@ void game_handle_paddle_buttons(GameState *state) {
 
 
 
+/**
+ * @brief Put the paddle where the potentiometer points, across the whole
+ *        travel between the walls. Only a turn moves it, so the buttons keep
+ *        working while the knob rests; the first reading of a game is taken
+ *        as the resting point.
+ */
+uint8_t game_handle_paddle_pot(GameState *state, uint8_t position) {
+    if (state->pot_last == position)
+        return 0;
+    uint8_t first = state->pot_last < 0;
+    state->pot_last = position;
+    if (first)
+        return 0;
+    if (!state->show_potentiometer_prompt) {
+        uint16_t max_x = SCREEN_WIDTH - state->paddle.width;
+        state->paddle.x = (uint32_t) position * max_x / POTENTIOMETER_POSITION_MAX;
+    }
+    return 1;
+}
+
 /**
  * @brief Displays the pause screen.
  */
@@ -234,13 +316,14 @@ void spawn_extra_ball(GameState *state, const Ball *template_ball) {
     Ball *new_ball = &state->balls[state->ball_count++];
     *new_ball = *template_ball;
     // Offset new ball slightly to avoid immediate overlap
-    new_ball->x += 8;
-    new_ball->y -= 5;
+    new_ball->x += FIX16_FROM_INT(8);
+    new_ball->y -= FIX16_FROM_INT(5);
     // Give slightly different velocity to spread apart
-    new_ball->dx = template_ball->dx * 0.9f - (template_ball->dx > 0 ? 15.0f : -15.0f);
-    new_ball->dy = template_ball->dy * 0.95f;
-    new_ball->prev_x = new_ball->x;
-    new_ball->prev_y = new_ball->y;
+    new_ball->dx = fix16_mul(template_ball->dx, FIX16_CONST(0.9))
+            - (template_ball->dx > 0 ? FIX16_FROM_INT(15) : FIX16_FROM_INT(-15));
+    new_ball->dy = fix16_mul(template_ball->dy, FIX16_CONST(0.95));
+    new_ball->prev_x = BALL_PX(new_ball);
+    new_ball->prev_y = BALL_PY(new_ball);
 }
 
 /**
@@ -255,6 +338,26 @@ void apply_plus_powerup(GameState *state) {
     }
 }
 
+/**
+ * @brief Seeds the game's random sequence (brick specials). Zero is not a
+ * valid xorshift state and is mapped to a fixed seed.
+ */
+void game_seed(GameState *state, uint32_t seed) {
+    state->rng = seed ? seed : 0x2545F491u;
+}
+
+/**
+ * @brief Next value of the xorshift32 sequence in state->rng.
+ */
+uint32_t game_rand(GameState *state) {
+    uint32_t x = state->rng;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    state->rng = x;
+    return x;
+}
+
 /**
  * @brief Initialize bricks for the given level.
  *        If animate=1, bricks start above screen (INCOMING) and drop down.
@@ -262,19 +365,24 @@ void apply_plus_powerup(GameState *state) {
  */
 void init_bricks_for_level(GameState *state, uint8_t level, uint8_t animate) {
     uint16_t brick_colors[BRICK_ROWS] = {BLUE, RED, YELLOW, GREEN, MAGENTA};
-    uint16_t total_height = BRICK_ROWS * (BRICK_HEIGHT + BRICK_GAP);
+    uint16_t total_height = BRICK_ROWS * BRICK_PITCH_Y;
     uint8_t drop_speed = 4 + (level - 1); // 4 px/frame base, +1 per level
     
-    srand((unsigned int)HAL_GetTick() + level);
+    state->brick_drop_offset = animate ? -(int16_t)total_height : 0;
+    state->brick_dropping = animate;
+    for (int row = 0; row < BRICK_ROWS; row++) {
+        state->brick_alive[row] = BRICK_ROW_MASK;
+    }
+    state->bricks_left = BRICK_ROWS * BRICK_COLS;
     for (int row = 0; row < BRICK_ROWS; row++) {
         for (int col = 0; col < BRICK_COLS; col++) {
             Brick *brick = &state->bricks[row][col];
             brick->width = BRICK_WIDTH;
             brick->height = BRICK_HEIGHT;
-            brick->x = GRID_PADDING_X + col * (BRICK_WIDTH + BRICK_GAP);
+            brick->x = GRID_PADDING_X + col * BRICK_PITCH_X;
             
             // Calculate final position
-            brick->final_y = GRID_START_Y + row * (BRICK_HEIGHT + BRICK_GAP);
+            brick->final_y = GRID_START_Y + row * BRICK_PITCH_Y;
             
             if (animate) {
                 // Start above screen and drop down (INCOMING state)
@@ -290,10 +398,10 @@ void init_bricks_for_level(GameState *state, uint8_t level, uint8_t animate) {
             brick->drop_speed = drop_speed;
             
             // Random assignment same probabilities
-            uint8_t rand_val = (uint8_t)(rand() % 100);
-            if (rand_val < 5) {
+            uint8_t rand_val = (uint8_t)(game_rand(state) % 100);
+            if (rand_val < BRICK_BALL_PERCENT) {
                 brick->special = BRICK_SPECIAL_BALL;
-            } else if (rand_val < 15) {
+            } else if (rand_val < BRICK_BALL_PERCENT + BRICK_PLUS_PERCENT) {
                 brick->special = BRICK_SPECIAL_PLUS;
             } else {
                 brick->special = BRICK_SPECIAL_NONE;
@@ -302,20 +410,40 @@ void init_bricks_for_level(GameState *state, uint8_t level, uint8_t animate) {
     }
 }
 
+/**
+ * @brief Moves the brick drop animation on by one physics step. The grid
+ * drops in lockstep and its bricks move from INCOMING state to ACTIVE when
+ * it lands.
+ */
+void game_advance_drop(GameState *state) {
+    if (!state->brick_dropping) return;
+    state->brick_drop_offset += state->bricks[0][0].drop_speed; // Move downward
+    if (state->brick_drop_offset >= 0) {
+        state->brick_drop_offset = 0; // Snap to final position
+        state->brick_dropping = 0;
+    }
+    for (int row = 0; row < BRICK_ROWS; row++) {
+        for (int col = 0; col < BRICK_COLS; col++) {
+            Brick *brick = &state->bricks[row][col];
+            if (brick->state == BRICK_STATE_INCOMING) {
+                brick->y = brick->final_y + state->brick_drop_offset;
+                if (!state->brick_dropping)
+                    brick->state = BRICK_STATE_ACTIVE; // Now ready for collision
+            }
+        }
+    }
+}
+
 /**
  * @brief Advance to next level: increase difficulty and reinit bricks.
  */
 void advance_level(GameState *state) {
     state->level++;
     // increase ball speed by 15% per level (cap can be added)
-    const float SPEED_MULT = 1.15f;
+    const fix16_t SPEED_MULT = FIX16_CONST(1.15);
     for (int i = 0; i < state->ball_count; i++) {
-        float dx = (float)state->balls[i].dx;
-        float dy = (float)state->balls[i].dy;
-        dx *= SPEED_MULT;
-        dy *= SPEED_MULT;
-        state->balls[i].dx = (int16_t)dx;
-        state->balls[i].dy = (int16_t)dy;
+        state->balls[i].dx = fix16_mul(state->balls[i].dx, SPEED_MULT);
+        state->balls[i].dy = fix16_mul(state->balls[i].dy, SPEED_MULT);
     }
     // reinitialize bricks for new level with drop animation (animate=1)
     init_bricks_for_level(state, state->level, 1);
@@ -338,53 +466,102 @@ void game_draw_game_over_screen(const GameState *state) {
 
 // --- Partial Update Functions ---
 void game_update_paddle(Paddle *paddle) {
-    // Erase old paddle
-    lcd_fill(paddle->prev_x, paddle->y, paddle->prev_x + paddle->width, paddle->y + paddle->height, BLACK);
-    // Draw new paddle
-    draw_paddle(paddle);
+    if (paddle->x != paddle->prev_x) {
+        game_mark_dirty(paddle->prev_x, paddle->y, paddle->prev_x + paddle->width, paddle->y + paddle->height);
+        game_mark_dirty(paddle->x, paddle->y, paddle->x + paddle->width, paddle->y + paddle->height);
+    }
     // Update previous position
     paddle->prev_x = paddle->x;
 }
 
+/**
+ * @brief Marks the area a ball moved across (old and new bounding boxes).
+ */
 void game_update_ball(Ball *ball) {
-    // Erase old ball
-    lcd_draw_circle(ball->prev_x, ball->prev_y, BLACK, ball->radius, 1);
-    // Draw new ball
-    draw_ball(ball);
+    int16_t r = ball->radius;
+    int16_t px = BALL_PX(ball), py = BALL_PY(ball);
+    int16_t x1 = ball->prev_x < px ? ball->prev_x : px;
+    int16_t x2 = ball->prev_x > px ? ball->prev_x : px;
+    int16_t y1 = ball->prev_y < py ? ball->prev_y : py;
+    int16_t y2 = ball->prev_y > py ? ball->prev_y : py;
+    if (x1 == x2 && y1 == y2) return; // not moved
+    game_mark_dirty(x1 - r, y1 - r, x2 + r + 1, y2 + r + 1);
 }
 
 /**
  * @brief Erases a single brick from the screen.
  */
 void game_erase_brick(const Brick* brick) {
-    lcd_fill(brick->x, brick->y, brick->x + brick->width, brick->y + brick->height, BLACK);
+    game_mark_dirty(brick->x, (int16_t)brick->y, brick->x + brick->width, (int16_t)brick->y + brick->height);
 }
 
+/**
+ * @brief Brings the UI bar up to date, redrawing only the life icons and
+ * glyphs whose value changed since the last call.
+ */
 void game_update_ui_bar(uint32_t score, uint8_t lives, uint8_t level) {
-    draw_ui_bar(lives, score, level);
+    char text[UI_TEXT_MAX];
+    uint8_t len;
+    uint8_t full = !ui_bar_valid;
+
+    for (int i = 0; i < MAX_LIVES; i++) {
+        if (!full && (i < lives) == (i < ui_lives)) continue;
+        // Filled circle if lives > i, otherwise hollow
+        lcd_draw_circle(15 + i * 20, 10, BLACK, 5, 1);
+        lcd_draw_circle(15 + i * 20, 10, WHITE, 5, (i < lives));
+    }
+    ui_lives = lives;
+
+    // Score, centered; a longer number moves every glyph
+    len = ui_format_uint(score, UI_SCORE_MIN_DIGITS, text);
+    ui_draw_text((SCREEN_WIDTH - len * UI_GLYPH_WIDTH) / 2, text, len,
+            ui_score_text, full || len != ui_score_len);
+    ui_score_len = len;
+
+    // Level, right aligned
+    memcpy(text, "LVL:", 4);
+    len = 4 + ui_format_uint(level, 1, text + 4);
+    ui_draw_text(SCREEN_WIDTH - len * UI_GLYPH_WIDTH - 4, text, len,
+            ui_level_text, full || len != ui_level_len);
+    ui_level_len = len;
+
+    ui_bar_valid = 1;
 }
 
 // --- Private Drawing Functions ---
 
 static void draw_ui_bar(uint8_t lives, uint32_t score, uint8_t level) {
-    // Draw lives as filled circles
-	for (int i = 0; i < MAX_LIVES; i++)
-		lcd_draw_circle(15 + i * 20, 10, BLACK, 5, 1);
-    for (int i = 0; i < MAX_LIVES; i++) {
-        // Draw filled circle if lives > i, otherwise hollow
-        lcd_draw_circle(15 + i * 20, 10, WHITE, 5, (i < lives));
-    }
+    ui_bar_valid = 0;
+    game_update_ui_bar(score, lives, level);
+}
+
+/**
+ * @brief Writes value in decimal, zero-padded to min_digits. Returns the
+ * number of characters written; no terminator is added.
+ */
+static uint8_t ui_format_uint(uint32_t value, uint8_t min_digits, char *out) {
+    char digits[UI_TEXT_MAX];
+    uint8_t n = 0;
+    do {
+        digits[n++] = '0' + value % 10;
+        value /= 10;
+    } while (value != 0);
+    while (n < min_digits) digits[n++] = '0';
+    for (uint8_t i = 0; i < n; i++) out[i] = digits[n - 1 - i];
+    return n;
+}
 
-    // Draw score (example format)
-    char score_str[10];
-    sprintf(score_str, "%05lu", score);
-    lcd_show_string_center(0, 2, score_str, WHITE, BLACK, 16, 0);
-    // Draw level on right side
-    char level_str[12];
-    sprintf(level_str, "LVL:%d", level);
-    int len = strlen(level_str);
-    int x = SCREEN_WIDTH - (len * 8) - 4;
-    lcd_show_string(x, 2, level_str, WHITE, BLACK, 16, 0);
+/**
+ * @brief Draws the glyphs of text that differ from shown (all of them when
+ * redraw_all is set) and records them in shown.
+ */
+static void ui_draw_text(uint16_t x, const char *text, uint8_t len,
+        char *shown, uint8_t redraw_all) {
+    for (uint8_t i = 0; i < len; i++) {
+        if (!redraw_all && text[i] == shown[i]) continue;
+        lcd_show_char(x + i * UI_GLYPH_WIDTH, UI_TEXT_Y, text[i], WHITE, BLACK, UI_FONT_SIZE, 0);
+        shown[i] = text[i];
+    }
 }
 
 void draw_game_border(void) {
@@ -448,10 +625,292 @@ static void draw_paddle(const Paddle *paddle) {
 }
 
 static void draw_ball(const Ball *ball) {
-    lcd_draw_circle(ball->x, ball->y, ball->color, ball->radius, 1); // Filled circle
+    lcd_draw_circle(BALL_PX(ball), BALL_PY(ball), ball->color, ball->radius, 1); // Filled circle
 }
 
 
+/**
+ * @brief Removes a ball from the screen at both its previous and current
+ * position. Call before the ball leaves state->balls; the area is repainted
+ * without it on the next flush.
+ */
 void game_erase_ball(const Ball *ball) {
-    lcd_draw_circle(ball->x, ball->y, BLACK, ball->radius, 1);
+    int16_t r = ball->radius;
+    int16_t px = BALL_PX(ball), py = BALL_PY(ball);
+    int16_t x1 = ball->prev_x < px ? ball->prev_x : px;
+    int16_t x2 = ball->prev_x > px ? ball->prev_x : px;
+    int16_t y1 = ball->prev_y < py ? ball->prev_y : py;
+    int16_t y2 = ball->prev_y > py ? ball->prev_y : py;
+    game_mark_dirty(x1 - r, y1 - r, x2 + r + 1, y2 + r + 1);
+}
+
+// --- Retained Brick Layer ---
+
+/**
+ * @brief Clips the rows [y, y + h) of a brick to the part of the play area
+ * the brick layer may paint directly (inside the border). Returns 0 when
+ * nothing is left.
+ */
+static uint8_t brick_clip_rows(int16_t y, uint16_t h, int16_t *y1, int16_t *y2) {
+    *y1 = y > UI_BAR_HEIGHT + 1 ? y : UI_BAR_HEIGHT + 1;
+    *y2 = y + (int16_t)h < SCREEN_HEIGHT - 1 ? y + (int16_t)h : SCREEN_HEIGHT - 1;
+    return *y1 < *y2;
+}
+
+static uint8_t brick_fully_visible(const Brick *brick, int16_t y) {
+    return y >= UI_BAR_HEIGHT && y + brick->height <= SCREEN_HEIGHT;
+}
+
+/**
+ * @brief Paints rows [y1, y2) of a brick. Plain strips go straight to the
+ * LCD; a strip under a ball is left to the compositor so the ball stays on top.
+ */
+static void brick_paint_rows(const GameState *state, const Brick *brick,
+        int16_t y1, int16_t y2) {
+    int16_t x2 = brick->x + brick->width;
+    for (int i = 0; i < state->ball_count; i++) {
+        const Ball *ball = &state->balls[i];
+        int16_t px = BALL_PX(ball), py = BALL_PY(ball);
+        if (px + ball->radius >= brick->x && px - ball->radius < x2 &&
+            py + ball->radius >= y1 && py - ball->radius < y2) {
+            game_mark_dirty(brick->x, y1, x2, y2);
+            return;
+        }
+    }
+    lcd_fill(brick->x, y1, x2, y2, brick->color);
+}
+
+/**
+ * @brief Records the bricks game_draw_initial_scene() just put on screen.
+ */
+static void brick_layer_reset(const GameState *state) {
+    for (int row = 0; row < BRICK_ROWS; row++) {
+        for (int col = 0; col < BRICK_COLS; col++) {
+            const Brick *brick = &state->bricks[row][col];
+            brick_drawn[row][col] = brick->state != BRICK_STATE_DESTROYED;
+            brick_drawn_y[row][col] = brick->y;
+        }
+    }
+}
+
+/**
+ * @brief Brings the screen in line with the brick grid. Only the rows a
+ * brick uncovered (erased through the compositor) or newly covers (filled
+ * directly) are touched; a brick with a special mark is repainted whole so
+ * the mark moves with it. Destroyed bricks are erased once.
+ */
+static void brick_layer_sync(const GameState *state) {
+    for (int row = 0; row < BRICK_ROWS; row++) {
+        for (int col = 0; col < BRICK_COLS; col++) {
+            const Brick *brick = &state->bricks[row][col];
+            int16_t old_y = brick_drawn_y[row][col];
+            int16_t o1, o2, n1, n2;
+            uint8_t had = brick_drawn[row][col] && brick_clip_rows(old_y, brick->height, &o1, &o2);
+
+            if (brick->state == BRICK_STATE_DESTROYED) {
+                if (brick_drawn[row][col]) {
+                    game_mark_dirty(brick->x, old_y, brick->x + brick->width, old_y + brick->height);
+                    brick_drawn[row][col] = 0;
+                }
+                continue;
+            }
+            if (brick_drawn[row][col] && old_y == brick->y) continue;
+
+            uint8_t has = brick_clip_rows(brick->y, brick->height, &n1, &n2);
+            if (!had) o1 = o2 = n1;
+            if (!has) n1 = n2 = o1;
+
+            // Rows only the old position covered
+            if (o1 < n1) game_mark_dirty(brick->x, o1, brick->x + brick->width, o2 < n1 ? o2 : n1);
+            if (o2 > n2) game_mark_dirty(brick->x, o1 > n2 ? o1 : n2, brick->x + brick->width, o2);
+
+            if (brick->special != BRICK_SPECIAL_NONE &&
+                (brick_fully_visible(brick, brick->y) || (had && brick_fully_visible(brick, old_y)))) {
+                game_mark_dirty(brick->x, brick->y, brick->x + brick->width, brick->y + brick->height);
+            } else if (has) {
+                // Rows only the new position covers
+                if (n1 < o1) brick_paint_rows(state, brick, n1, n2 < o1 ? n2 : o1);
+                if (n2 > o2) brick_paint_rows(state, brick, n1 > o2 ? n1 : o2, n2);
+            }
+            brick_drawn[row][col] = 1;
+            brick_drawn_y[row][col] = brick->y;
+        }
+    }
+}
+
+// --- Scene Compositing ---
+
+/**
+ * @brief Renders one line of the play area from the scene description.
+ * Layers bottom to top: background, bricks (with their special marks),
+ * paddle, border, balls. Mirrors what the draw_* functions put on screen.
+ */
+static void render_scene_row(const GameState *state, int16_t x, int16_t y,
+        uint16_t w, uint16_t *row) {
+    int16_t x_end = x + w;
+
+    for (uint16_t i = 0; i < w; i++) row[i] = BLACK;
+
+    for (int r = 0; r < BRICK_ROWS; r++) {
+        for (int c = 0; c < BRICK_COLS; c++) {
+            const Brick *brick = &state->bricks[r][c];
+            if (brick->state == BRICK_STATE_DESTROYED) continue;
+            int16_t by = brick->y;
+            if (y < by || y >= by + brick->height) continue;
+            int16_t bx = brick->x;
+            int16_t from = bx > x ? bx : x;
+            int16_t to = bx + brick->width < x_end ? bx + brick->width : x_end;
+            for (int16_t i = from; i < to; i++) row[i - x] = brick->color;
+
+            // Special marks only appear on fully visible bricks
+            if (by < UI_BAR_HEIGHT || by + brick->height > SCREEN_HEIGHT) continue;
+            int16_t cx = bx + brick->width / 2;
+            int16_t cy = by + brick->height / 2;
+            if (brick->special == BRICK_SPECIAL_BALL) {
+                int16_t line = y - (cy - SPECIAL_BALL_RADIUS);
+                if (line < 0 || line > 2 * SPECIAL_BALL_RADIUS) continue;
+                if (!special_ball_rows_ready) {
+                    lcd_circle_outline_rows(SPECIAL_BALL_RADIUS, special_ball_rows);
+                    special_ball_rows_ready = 1;
+                }
+                uint32_t bits = special_ball_rows[line];
+                for (int16_t i = 0; i <= 2 * SPECIAL_BALL_RADIUS; i++) {
+                    int16_t px = cx - SPECIAL_BALL_RADIUS + i;
+                    if ((bits & (1UL << i)) && px >= x && px < x_end) row[px - x] = WHITE;
+                }
+            } else if (brick->special == BRICK_SPECIAL_PLUS) {
+                // lcd_draw_line() stops one pixel short of its end point
+                int16_t half_len = (brick->height / 2) - 2;
+                if (y == cy) {
+                    for (int16_t px = cx - half_len; px < cx + half_len; px++) {
+                        if (px >= x && px < x_end) row[px - x] = BLACK;
+                    }
+                } else if (y >= cy - half_len && y < cy + half_len && cx >= x && cx < x_end) {
+                    row[cx - x] = BLACK;
+                }
+            }
+        }
+    }
+
+    const Paddle *paddle = &state->paddle;
+    if (y >= paddle->y && y < paddle->y + paddle->height) {
+        int16_t from = paddle->x > x ? paddle->x : x;
+        int16_t to = paddle->x + paddle->width < x_end ? paddle->x + paddle->width : x_end;
+        for (int16_t i = from; i < to; i++) row[i - x] = paddle->color;
+    }
+
+    // Border: lcd_draw_rectangle(0, UI_BAR_HEIGHT, SCREEN_WIDTH - 1, SCREEN_HEIGHT - 1)
+    if (y == UI_BAR_HEIGHT || y == SCREEN_HEIGHT - 1) {
+        for (uint16_t i = 0; i < w; i++) row[i] = RED;
+    } else {
+        if (x == 0) row[0] = RED;
+        if (x_end == SCREEN_WIDTH) row[w - 1] = RED;
+    }
+
+    for (int i = 0; i < state->ball_count; i++) {
+        const Ball *ball = &state->balls[i];
+        int16_t px = BALL_PX(ball), py = BALL_PY(ball);
+        if (ball->radius != ball_sprite_radius || ball->color != ball_sprite_color) {
+            if (!sprite_build_ball(&ball_sprite, ball->radius, ball->color)) {
+                // Too large for a sprite: paint the circle span directly
+                const uint16_t *spans = lcd_circle_spans(ball->radius);
+                int16_t dy = y > py ? y - py : py - y;
+                if (spans == NULL || dy > ball->radius) continue;
+                int16_t from = px - spans[dy] > x ? px - spans[dy] : x;
+                int16_t to = px + spans[dy] + 1 < x_end ? px + spans[dy] + 1 : x_end;
+                for (int16_t px = from; px < to; px++) row[px - x] = ball->color;
+                continue;
+            }
+            ball_sprite_radius = ball->radius;
+            ball_sprite_color = ball->color;
+        }
+        sprite_blend_row(&ball_sprite, px - ball->radius, py - ball->radius,
+                x, y, w, row);
+    }
+}
+
+/**
+ * @brief Recomposes one dirty rectangle from the scene and streams it to the
+ * LCD through one address window.
+ */
+static void compose_box(const GameState *state, const DirtyRect *box) {
+    uint16_t w = box->x2 - box->x1;
+    lcd_set_address(box->x1, box->y1, box->x2 - 1, box->y2 - 1);
+    for (int16_t y = box->y1; y < box->y2; y++) {
+        render_scene_row(state, box->x1, y, w, compose_line);
+        lcd_write_pixels(compose_line, w);
+    }
+}
+
+static uint32_t rect_area(const DirtyRect *r) {
+    return (uint32_t)(r->x2 - r->x1) * (uint32_t)(r->y2 - r->y1);
+}
+
+static DirtyRect rect_union(const DirtyRect *a, const DirtyRect *b) {
+    DirtyRect u;
+    u.x1 = a->x1 < b->x1 ? a->x1 : b->x1;
+    u.y1 = a->y1 < b->y1 ? a->y1 : b->y1;
+    u.x2 = a->x2 > b->x2 ? a->x2 : b->x2;
+    u.y2 = a->y2 > b->y2 ? a->y2 : b->y2;
+    return u;
+}
+
+/**
+ * @brief Marks the play-area rectangle [x1, x2) x [y1, y2) for repaint on the
+ * next game_flush_dirty(). Rectangles that overlap, or whose union costs no
+ * more than drawing them apart, are merged.
+ */
+void game_mark_dirty(int16_t x1, int16_t y1, int16_t x2, int16_t y2) {
+    DirtyRect rect;
+    if (x1 < 0) x1 = 0;
+    if (y1 < UI_BAR_HEIGHT) y1 = UI_BAR_HEIGHT;
+    if (x2 > SCREEN_WIDTH) x2 = SCREEN_WIDTH;
+    if (y2 > SCREEN_HEIGHT) y2 = SCREEN_HEIGHT;
+    if (x1 >= x2 || y1 >= y2) return;
+    rect.x1 = x1; rect.y1 = y1; rect.x2 = x2; rect.y2 = y2;
+
+    // Absorb every rectangle worth merging; the grown rectangle may now
+    // reach others, so rescan until nothing merges
+    uint8_t merged = 1;
+    while (merged) {
+        merged = 0;
+        for (uint8_t i = 0; i < dirty_count; i++) {
+            DirtyRect u = rect_union(&rect, &dirty_rects[i]);
+            if (rect_area(&u) <= rect_area(&rect) + rect_area(&dirty_rects[i]) + DIRTY_MERGE_SLACK) {
+                rect = u;
+                dirty_rects[i] = dirty_rects[--dirty_count];
+                merged = 1;
+                break;
+            }
+        }
+    }
+
+    if (dirty_count == DIRTY_MAX_RECTS) {
+        // List full: fold into the rectangle that grows the least
+        uint8_t best = 0;
+        uint32_t best_growth = UINT32_MAX;
+        for (uint8_t i = 0; i < dirty_count; i++) {
+            DirtyRect u = rect_union(&rect, &dirty_rects[i]);
+            uint32_t growth = rect_area(&u) - rect_area(&dirty_rects[i]);
+            if (growth < best_growth) {
+                best_growth = growth;
+                best = i;
+            }
+        }
+        rect = rect_union(&rect, &dirty_rects[best]);
+        dirty_rects[best] = dirty_rects[--dirty_count];
+        game_mark_dirty(rect.x1, rect.y1, rect.x2, rect.y2);
+        return;
+    }
+    dirty_rects[dirty_count++] = rect;
+}
+
+/**
+ * @brief Repaints every dirty rectangle from the scene and clears the list.
+ */
+void game_flush_dirty(const GameState *state) {
+    for (uint8_t i = 0; i < dirty_count; i++) {
+        compose_box(state, &dirty_rects[i]);
+    }
+    dirty_count = 0;
 }
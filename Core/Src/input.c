@@ -0,0 +1,172 @@
+/*
+ * input.c
+ *
+ * Events are timed on an input clock that advances scan_ms per
+ * input_update(), not on HAL_GetTick(), so a replayed session produces the
+ * same events however fast it runs. Latency is measured in real ticks: from
+ * the update that reported a press to the next input_frame_presented().
+ */
+
+/* Includes */
+#include "input.h"
+#include "button.h"
+#include "main.h"
+
+/* Variables */
+input_config_t input_config;
+input_latency_t input_latency;
+uint32_t input_overflow = 0;	// events dropped on a full queue
+
+static const input_config_t input_default_config = {
+	.scan_ms = BUTTON_SCAN_MS,
+	.debounce_ms = BUTTON_SCAN_MS,	// one confirming scan
+	.hold_ms = 500,
+	.repeat_ms = 100
+};
+
+static input_event_t input_queue[INPUT_QUEUE_SIZE];
+static uint8_t input_head = 0;
+static uint8_t input_count = 0;
+
+static uint32_t input_time = 0;
+static uint16_t input_raw = 0;			// last scanned levels
+static uint16_t input_stable = 0;		// debounced levels
+static uint16_t input_held_fired = 0;	// INPUT_HOLD sent for this press
+static uint32_t input_raw_since[16];	// input_time of the last raw change
+static uint32_t input_next[16];			// input_time of the next hold/repeat
+
+static uint8_t input_latency_pending = 0;
+static uint32_t input_latency_tick = 0;	// HAL_GetTick() at the oldest pending press
+
+/* Functions */
+/**
+ * @brief  	Set the configuration and forget all button state and events
+ * @param  	config Timings, or NULL for the defaults
+ * @retval 	None
+ */
+void input_init(const input_config_t *config) {
+	input_config = config != NULL ? *config : input_default_config;
+	input_head = 0;
+	input_count = 0;
+	input_overflow = 0;
+	input_time = 0;
+	input_raw = 0;
+	input_stable = 0;
+	input_held_fired = 0;
+	for (uint8_t i = 0; i < 16; i++) {
+		input_raw_since[i] = 0;
+		input_next[i] = 0;
+	}
+	input_latency.count = 0;
+	input_latency.stale = 0;
+	input_latency.min = UINT32_MAX;
+	input_latency.max = 0;
+	input_latency.total = 0;
+	input_latency_pending = 0;
+}
+
+static void input_push(input_event_type_t type, uint8_t button) {
+	if (input_count == INPUT_QUEUE_SIZE) {
+		input_overflow++;
+		return;
+	}
+	input_event_t *event = &input_queue[(input_head + input_count) % INPUT_QUEUE_SIZE];
+	event->type = type;
+	event->button = button;
+	event->time = input_time;
+	input_count++;
+}
+
+/**
+ * @brief  	Feed one scan of held buttons
+ * @param  	held Bit n set = button n pressed
+ * @note  	Call once per scan with the mask session_buttons() returned
+ * @retval 	None
+ */
+void input_update(uint16_t held) {
+	input_time += input_config.scan_ms;
+	uint16_t changed = held ^ input_raw;
+	input_raw = held;
+
+	for (uint8_t i = 0; i < 16; i++) {
+		uint16_t mask = 1u << i;
+		if (changed & mask)
+			input_raw_since[i] = input_time;
+
+		if (((input_stable ^ input_raw) & mask)
+				&& input_time - input_raw_since[i] >= input_config.debounce_ms) {
+			input_stable ^= mask;
+			if (input_stable & mask) {
+				input_push(INPUT_PRESS, i);
+				input_held_fired &= ~mask;
+				input_next[i] = input_time + input_config.hold_ms;
+				if (!input_latency_pending) {
+					input_latency_pending = 1;
+					input_latency_tick = HAL_GetTick();
+				}
+			} else {
+				input_push(INPUT_RELEASE, i);
+			}
+		}
+
+		if (!(input_stable & mask) || input_config.hold_ms == 0
+				|| (int32_t) (input_time - input_next[i]) < 0)
+			continue;
+		if (!(input_held_fired & mask)) {
+			input_push(INPUT_HOLD, i);
+			input_held_fired |= mask;
+		} else if (input_config.repeat_ms != 0) {
+			input_push(INPUT_REPEAT, i);
+		} else {
+			input_next[i] = input_time + UINT32_MAX / 2;	// hold sent, no repeat
+			continue;
+		}
+		input_next[i] += input_config.repeat_ms;
+	}
+}
+
+/**
+ * @brief  	Take the oldest event
+ * @param  	event Receives the event
+ * @retval 	1 if an event was taken, 0 if the queue is empty
+ */
+uint8_t input_pop(input_event_t *event) {
+	if (input_count == 0)
+		return 0;
+	*event = input_queue[input_head];
+	input_head = (input_head + 1) % INPUT_QUEUE_SIZE;
+	input_count--;
+	return 1;
+}
+
+/**
+ * @brief  	Debounced level of a button
+ * @param  	button Bit index in button_decode()'s held mask
+ * @retval 	1 while pressed
+ */
+uint8_t input_held(uint8_t button) {
+	return (input_stable >> button) & 1;
+}
+
+/**
+ * @brief  	A frame reached the screen: close the pending press latency
+ * @param  	None
+ * @note  	Call after every render, including full-screen redraws
+ * @retval 	None
+ */
+void input_frame_presented(void) {
+	if (!input_latency_pending)
+		return;
+	input_latency_pending = 0;
+	uint32_t latency = HAL_GetTick() - input_latency_tick;
+	if (latency > INPUT_LATENCY_MAX_MS) {
+		input_latency.stale++;
+		return;
+	}
+	input_latency.count++;
+	input_latency.total += latency;
+	if (latency < input_latency.min)
+		input_latency.min = latency;
+	if (latency > input_latency.max)
+		input_latency.max = latency;
+}
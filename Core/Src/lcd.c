@@ -5,28 +5,66 @@
 #include <lcd_font.h>
 #include "lcd.h"
 #include "fsmc.h"
+#include "dma.h"
+#include <stddef.h>
 #include <stdlib.h>
 #include <string.h>
 
+// Longest transfer a DMA stream accepts (NDTR is 16 bit)
+#define LCD_DMA_MAX_CHUNK   65535U
+// Below this many pixels the CPU loop is cheaper than setting up the DMA
+#define LCD_DMA_MIN_PIXELS  64U
+#define LCD_DATA_ADDR       (LCD_BASE + offsetof(LCD_TypeDef, LCD_RAM))
+// Filled circles up to this radius keep their span table cached
+#define LCD_CIRCLE_CACHE_R  16
+// Largest radius lcd_fill_circle rasterizes with spans
+#define LCD_CIRCLE_MAX_R    160
+// Characters per text line: a 320 pixel row of 12 pixel high (6 wide) glyphs
+#define LCD_TEXT_MAX_CHARS  (320 / 6)
+
 unsigned char s[50];
 
 _lcd_dev lcddev;
 
+// Pending DMA transfer: rows of words streamed back to back into one window
+typedef struct {
+	const uint16_t *src;    // next source word
+	uint32_t remaining;     // words left in the current row
+	uint32_t row_length;    // words per row
+	uint32_t row_skip;      // source words skipped between rows
+	uint16_t rows;          // rows left after the current one
+	uint8_t src_inc;        // 0: repeat *src (fill), 1: walk the source
+} lcd_dma_job_t;
+
+static volatile uint8_t lcd_dma_active = 0;
+static lcd_dma_job_t lcd_dma_job;
+static uint16_t lcd_dma_color;
+static uint32_t lcd_dma_src_inc = DMA_PINC_DISABLE;
+static void (*lcd_dma_callback)(void) = NULL;
+
+static uint16_t circle_span_cache[LCD_CIRCLE_CACHE_R + 1][LCD_CIRCLE_CACHE_R + 1];
+static uint32_t circle_span_cached = 0; // bit r set: row r of the cache is valid
+static uint16_t circle_span_scratch[LCD_CIRCLE_MAX_R + 1];
+
 static void LCD_WR_DATA(uint16_t data);
 static uint16_t LCD_RD_DATA(void);
 static uint32_t mypow(uint8_t m, uint8_t n);
+static void lcd_show_text_line(uint16_t x, uint16_t y, const char *str,
+		uint16_t count, uint16_t fc, uint16_t bc, uint8_t sizey, uint8_t mode);
 
 void LCD_WR_REG(uint16_t reg) {
-	LCD->LCD_REG = reg;
+	// A new command must not interleave with a fill still streaming by DMA
+	lcd_dma_wait();
+	LCD_BUS_WR_REG(reg);
 }
 
 void LCD_WR_DATA(uint16_t data) {
-	LCD->LCD_RAM = data;
+	LCD_BUS_WR_DATA(data);
 }
 
 uint16_t LCD_RD_DATA(void) {
 	__IO uint16_t ram;
-	ram = LCD->LCD_RAM;
+	ram = LCD_BUS_RD_DATA();
 	return ram;
 }
 
@@ -62,6 +100,110 @@ void lcd_set_display_off(void) {
 	LCD_WR_REG(0X28);
 }
 
+/**
+ * @brief  Switch the stream between a fixed source (fills) and an
+ *         incrementing source (pictures)
+ * @note   Only reprograms the stream when the mode actually changes
+ */
+static void lcd_dma_set_src_inc(uint8_t inc) {
+	uint32_t mode = inc ? DMA_PINC_ENABLE : DMA_PINC_DISABLE;
+	if (mode == lcd_dma_src_inc)
+		return;
+	lcd_dma_src_inc = mode;
+	hdma_memtomem_dma2_stream1.Init.PeriphInc = mode;
+	HAL_DMA_Init(&hdma_memtomem_dma2_stream1);
+}
+
+/**
+ * @brief  Start the next chunk of the pending DMA job
+ * @note   The destination is always the fixed FSMC data address
+ */
+static void lcd_dma_start_chunk(void) {
+	lcd_dma_job_t *job = &lcd_dma_job;
+	const uint16_t *src = job->src;
+	uint32_t count = job->remaining;
+	if (count > LCD_DMA_MAX_CHUNK)
+		count = LCD_DMA_MAX_CHUNK;
+	// Book the chunk before starting it: the completion interrupt may run
+	// before HAL_DMA_Start_IT returns
+	job->remaining -= count;
+	if (job->src_inc)
+		job->src += count;
+	if (HAL_DMA_Start_IT(&hdma_memtomem_dma2_stream1, (uintptr_t) src,
+			LCD_DATA_ADDR, count) != HAL_OK) {
+		job->remaining = 0;
+		job->rows = 0;
+		lcd_dma_active = 0;
+	}
+}
+
+/**
+ * @brief  Queue a job on the stream and start its first chunk
+ * @note   The caller must have set the address window
+ */
+static void lcd_dma_start(const uint16_t *src, uint8_t src_inc,
+		uint32_t row_length, uint16_t rows, uint32_t row_skip) {
+	lcd_dma_set_src_inc(src_inc);
+	lcd_dma_job.src = src;
+	lcd_dma_job.src_inc = src_inc;
+	lcd_dma_job.row_length = row_length;
+	lcd_dma_job.row_skip = row_skip;
+	lcd_dma_job.remaining = row_length;
+	lcd_dma_job.rows = rows - 1;
+	lcd_dma_active = 1;
+	lcd_dma_start_chunk();
+}
+
+static void lcd_dma_xfer_cplt(DMA_HandleTypeDef *hdma) {
+	lcd_dma_job_t *job = &lcd_dma_job;
+	if (job->remaining == 0 && job->rows > 0) {
+		job->rows--;
+		job->remaining = job->row_length;
+		if (job->src_inc)
+			job->src += job->row_skip;
+	}
+	if (job->remaining > 0) {
+		lcd_dma_start_chunk();
+		return;
+	}
+	lcd_dma_active = 0;
+	if (lcd_dma_callback != NULL)
+		lcd_dma_callback();
+}
+
+static void lcd_dma_xfer_error(DMA_HandleTypeDef *hdma) {
+	lcd_dma_job.remaining = 0;
+	lcd_dma_job.rows = 0;
+	lcd_dma_active = 0;
+}
+
+/**
+ * @brief  Check whether a DMA transfer is still streaming to the LCD
+ * @retval 1 if busy, 0 otherwise
+ */
+uint8_t lcd_dma_busy(void) {
+	return lcd_dma_active;
+}
+
+/**
+ * @brief  Block until the pending DMA transfer has completed
+ * @retval None
+ */
+void lcd_dma_wait(void) {
+	while (lcd_dma_active)
+		;
+}
+
+/**
+ * @brief  Register a function called (from the DMA interrupt) when a
+ *         transfer completes
+ * @param  callback Function to call, NULL to disable
+ * @retval None
+ */
+void lcd_dma_set_callback(void (*callback)(void)) {
+	lcd_dma_callback = callback;
+}
+
 uint16_t lcd_read_point(uint16_t x, uint16_t y) {
 	uint16_t r = 0, g = 0, b = 0;
 	lcd_set_cursor(x, y);
@@ -80,13 +222,7 @@ uint16_t lcd_read_point(uint16_t x, uint16_t y) {
  * @retval None
  */
 void lcd_clear(uint16_t color) {
-	uint16_t i, j;
-	lcd_set_address(0, 0, lcddev.width - 1, lcddev.height - 1);
-	for (i = 0; i < lcddev.width; i++) {
-		for (j = 0; j < lcddev.height; j++) {
-			LCD_WR_DATA(color);
-		}
-	}
+	lcd_fill(0, 0, lcddev.width, lcddev.height, color);
 }
 
 /**
@@ -96,17 +232,38 @@ void lcd_clear(uint16_t color) {
  * @param  xend	End column
  * @param  yend	End row
  * @param  color Color to fill
+ * @note   Large fills are streamed by DMA and this returns before they
+ *         complete; the next LCD command waits for them (see lcd_dma_wait)
  * @retval None
  */
 void lcd_fill(uint16_t xsta, uint16_t ysta, uint16_t xend, uint16_t yend,
 		uint16_t color) {
-	uint16_t i, j;
+	uint32_t i, count;
+	if (xend <= xsta || yend <= ysta)
+		return;
+	count = (uint32_t) (xend - xsta) * (yend - ysta);
 	lcd_set_address(xsta, ysta, xend - 1, yend - 1);
-	for (i = ysta; i < yend; i++) {
-		for (j = xsta; j < xend; j++) {
+	if (count < LCD_DMA_MIN_PIXELS) {
+		for (i = 0; i < count; i++)
 			LCD_WR_DATA(color);
-		}
+		return;
 	}
+	lcd_dma_color = color;
+	lcd_dma_start(&lcd_dma_color, 0, count, 1, 0);
+}
+
+/**
+ * @brief  Stream pixels into the current address window
+ * @param  pixels RGB565 pixels
+ * @param  count Number of pixels
+ * @note   Call after lcd_set_address; rows continue where the last call
+ *         stopped
+ * @retval None
+ */
+void lcd_write_pixels(const uint16_t *pixels, uint32_t count) {
+	uint32_t i;
+	for (i = 0; i < count; i++)
+		LCD_WR_DATA(pixels[i]);
 }
 
 /**
@@ -139,6 +296,22 @@ void lcd_draw_line(uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2,
 	delta_y = y2 - y1;
 	uRow = x1;
 	uCol = y1;
+	// Axis-aligned: one window per line. Like the stepping below, the end
+	// point itself is not drawn
+	if (delta_y == 0 && delta_x != 0) {
+		if (delta_x > 0)
+			lcd_draw_hline(x1, y1, delta_x, color);
+		else
+			lcd_draw_hline(x2 + 1, y1, -delta_x, color);
+		return;
+	}
+	if (delta_x == 0 && delta_y != 0) {
+		if (delta_y > 0)
+			lcd_draw_vline(x1, y1, delta_y, color);
+		else
+			lcd_draw_vline(x1, y2 + 1, -delta_y, color);
+		return;
+	}
 	if (delta_x > 0)
 		incx = 1;
 	else if (delta_x == 0)
@@ -174,59 +347,173 @@ void lcd_draw_line(uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2,
 	}
 }
 
+/**
+ * @brief  Draw a horizontal line through one address window
+ * @param  x X coordinate of the left end
+ * @param  y Y coordinate
+ * @param  length Number of pixels
+ * @param  color Color to fill
+ * @retval None
+ */
+void lcd_draw_hline(uint16_t x, uint16_t y, uint16_t length, uint16_t color) {
+	lcd_fill(x, y, x + length, y + 1, color);
+}
+
+/**
+ * @brief  Draw a vertical line through one address window
+ * @param  x X coordinate
+ * @param  y Y coordinate of the top end
+ * @param  length Number of pixels
+ * @param  color Color to fill
+ * @retval None
+ */
+void lcd_draw_vline(uint16_t x, uint16_t y, uint16_t length, uint16_t color) {
+	lcd_fill(x, y, x + 1, y + length, color);
+}
+
+/**
+ * @brief  Draw a rectangle outline, one address window per edge
+ * @param  x1 X coordinate of one corner
+ * @param  y1 Y coordinate of one corner
+ * @param  x2 X coordinate of the opposite corner
+ * @param  y2 Y coordinate of the opposite corner
+ * @param  color Color to fill
+ * @note   Both corners are inclusive
+ * @retval None
+ */
 void lcd_draw_rectangle(uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2,
 		uint16_t color) {
-	lcd_draw_line(x1, y1, x2, y1, color);
-	lcd_draw_line(x1, y1, x1, y2, color);
-	lcd_draw_line(x1, y2, x2, y2, color);
-	lcd_draw_line(x2, y1, x2, y2, color);
+	uint16_t t;
+	if (x2 < x1) {
+		t = x1;
+		x1 = x2;
+		x2 = t;
+	}
+	if (y2 < y1) {
+		t = y1;
+		y1 = y2;
+		y2 = t;
+	}
+	lcd_draw_hline(x1, y1, x2 - x1 + 1, color);
+	if (y2 == y1)
+		return;
+	lcd_draw_hline(x1, y2, x2 - x1 + 1, color);
+	lcd_draw_vline(x1, y1 + 1, y2 - y1 - 1, color);
+	lcd_draw_vline(x2, y1 + 1, y2 - y1 - 1, color);
 }
 
-void lcd_show_char(uint16_t x, uint16_t y, uint8_t character, uint16_t fc,
-		uint16_t bc, uint8_t sizey, uint8_t mode) {
-	uint8_t temp, sizex, t, m = 0;
-	uint16_t i, TypefaceNum;
-	uint16_t x0 = x;
-	sizex = sizey / 2;
-	TypefaceNum = (sizex / 8 + ((sizex % 8) ? 1 : 0)) * sizey;
-	character = character - ' ';
-	lcd_set_address(x, y, x + sizex - 1, y + sizey - 1);
-	for (i = 0; i < TypefaceNum; i++) {
-		if (sizey == 12)
-			;
-		else if (sizey == 16)
-			temp = ascii_1608[character][i];
-		else if (sizey == 24)
-			temp = ascii_2412[character][i];
-		else if (sizey == 32)
-			temp = ascii_3216[character][i];
-		else
-			return;
-		for (t = 0; t < 8; t++) {
-			if (!mode) {
-				if (temp & (0x01 << t))
-					LCD_WR_DATA(fc);
-				else
-					LCD_WR_DATA(bc);
-				m++;
-				if (m % sizex == 0) {
-					m = 0;
-					break;
-				}
-			} else {
-				if (temp & (0x01 << t))
-					lcd_draw_point(x, y, fc);
-				x++;
-				if ((x - x0) == sizex) {
-					x = x0;
-					y++;
-					break;
+/**
+ * @brief  Glyph of a character in the font of the given height
+ * @param  character ASCII character
+ * @param  sizey Font height: 12, 16, 24 or 32
+ * @retval Glyph rows, or NULL if the size or character is not in the fonts
+ */
+static const unsigned char* lcd_glyph(uint8_t character, uint8_t sizey) {
+	if (character < ' ' || character > '~')
+		return NULL;
+	character -= ' ';
+	switch (sizey) {
+	case 12:
+		return ascii_1206[character];
+	case 16:
+		return ascii_1608[character];
+	case 24:
+		return ascii_2412[character];
+	case 32:
+		return ascii_3216[character];
+	default:
+		return NULL;
+	}
+}
+
+/**
+ * @brief  One row of a glyph as a bit mask, bit 0 is the leftmost pixel
+ */
+static uint32_t lcd_glyph_row(const unsigned char *glyph, uint8_t row,
+		uint8_t sizex) {
+	uint8_t bytes = (sizex + 7) / 8;
+	uint32_t bits = 0;
+	if (glyph == NULL)
+		return 0;
+	for (uint8_t i = 0; i < bytes; i++)
+		bits |= (uint32_t) glyph[row * bytes + i] << (8 * i);
+	return bits;
+}
+
+/**
+ * @brief  Draw a run of characters on one text line
+ * @param  x X coordinate of the first character
+ * @param  y Y coordinate
+ * @param  str Characters; ones missing from the font are drawn blank
+ * @param  count Number of characters
+ * @param  fc Foreground color
+ * @param  bc Background color
+ * @param  sizey Font height: 12, 16, 24 or 32
+ * @param  mode 0: opaque, the whole run is one address window;
+ *         1: transparent, each run of set pixels in a row is one window
+ * @retval None
+ */
+static void lcd_show_text_line(uint16_t x, uint16_t y, const char *str,
+		uint16_t count, uint16_t fc, uint16_t bc, uint8_t sizey, uint8_t mode) {
+	const unsigned char *glyphs[LCD_TEXT_MAX_CHARS];
+	uint8_t sizex = sizey / 2;
+	uint16_t i, row, t;
+
+	if (lcd_glyph(' ', sizey) == NULL || count == 0)
+		return;
+	if (count > LCD_TEXT_MAX_CHARS)
+		count = LCD_TEXT_MAX_CHARS;
+	for (i = 0; i < count; i++)
+		glyphs[i] = lcd_glyph(str[i], sizey);
+
+	if (!mode) {
+		lcd_set_address(x, y, x + count * sizex - 1, y + sizey - 1);
+		for (row = 0; row < sizey; row++) {
+			for (i = 0; i < count; i++) {
+				uint32_t bits = lcd_glyph_row(glyphs[i], row, sizex);
+				for (t = 0; t < sizex; t++)
+					LCD_WR_DATA((bits >> t) & 1 ? fc : bc);
+			}
+		}
+		return;
+	}
+
+	for (row = 0; row < sizey; row++) {
+		uint16_t run = 0; // set pixels ending just left of px
+		uint16_t px = 0;
+		for (i = 0; i < count; i++) {
+			uint32_t bits = lcd_glyph_row(glyphs[i], row, sizex);
+			for (t = 0; t < sizex; t++, px++) {
+				if ((bits >> t) & 1) {
+					run++;
+				} else if (run) {
+					lcd_fill(x + px - run, y + row, x + px, y + row + 1, fc);
+					run = 0;
 				}
 			}
 		}
+		if (run)
+			lcd_fill(x + px - run, y + row, x + px, y + row + 1, fc);
 	}
 }
 
+/**
+ * @brief  Draw one character
+ * @param  x X coordinate
+ * @param  y Y coordinate
+ * @param  character ASCII character
+ * @param  fc Foreground color
+ * @param  bc Background color, unused in transparent mode
+ * @param  sizey Font height: 12, 16, 24 or 32
+ * @param  mode 0: opaque, 1: transparent
+ * @retval None
+ */
+void lcd_show_char(uint16_t x, uint16_t y, uint8_t character, uint16_t fc,
+		uint16_t bc, uint8_t sizey, uint8_t mode) {
+	char c = (char) character;
+	lcd_show_text_line(x, y, &c, 1, fc, bc, sizey, mode);
+}
+
 uint32_t mypow(uint8_t m, uint8_t n) {
 	uint32_t result = 1;
 	while (n--)
@@ -270,20 +557,53 @@ void lcd_show_float_num(uint16_t x, uint16_t y, float num, uint8_t len,
 	}
 }
 
+/**
+ * @brief  Draw a picture
+ * @param  x X coordinate of the top-left corner
+ * @param  y Y coordinate of the top-left corner
+ * @param  length Picture width in pixels
+ * @param  width Picture height in pixels
+ * @param  pic RGB565 pixels, row by row
+ * @note   Streamed by DMA straight from flash; returns before completion
+ * @retval None
+ */
 void lcd_show_picture(uint16_t x, uint16_t y, uint16_t length, uint16_t width,
-		const uint8_t pic[]) {
-	uint8_t picH, picL;
-	uint16_t i, j;
-	uint32_t k = 0;
+		const uint16_t pic[]) {
+	lcd_show_picture_region(x, y, length, width, pic, length, 0, 0);
+}
+
+/**
+ * @brief  Draw a sub-rectangle of a larger picture
+ * @param  x X coordinate of the top-left corner on screen
+ * @param  y Y coordinate of the top-left corner on screen
+ * @param  length Region width in pixels
+ * @param  width Region height in pixels
+ * @param  pic RGB565 pixels of the whole picture, row by row
+ * @param  pic_length Width of the whole picture in pixels
+ * @param  src_x X coordinate of the region inside the picture
+ * @param  src_y Y coordinate of the region inside the picture
+ * @retval None
+ */
+void lcd_show_picture_region(uint16_t x, uint16_t y, uint16_t length,
+		uint16_t width, const uint16_t pic[], uint16_t pic_length,
+		uint16_t src_x, uint16_t src_y) {
+	uint32_t i, j, count;
+	const uint16_t *src = &pic[(uint32_t) src_y * pic_length + src_x];
+	if (length == 0 || width == 0)
+		return;
+	count = (uint32_t) length * width;
 	lcd_set_address(x, y, x + length - 1, y + width - 1);
-	for (i = 0; i < length; i++) {
-		for (j = 0; j < width; j++) {
-			picH = pic[k * 2];
-			picL = pic[k * 2 + 1];
-			LCD_WR_DATA(picH << 8 | picL);
-			k++;
+	if (count < LCD_DMA_MIN_PIXELS) {
+		for (i = 0; i < width; i++, src += pic_length) {
+			for (j = 0; j < length; j++)
+				LCD_WR_DATA(src[j]);
 		}
+		return;
 	}
+	if (pic_length == length)
+		lcd_dma_start(src, 1, count, 1, 0); // contiguous rows: one job
+	else
+		lcd_dma_start(src, 1, length, width, pic_length - length);
 }
 
 void lcd_set_direction(uint8_t dir) {
@@ -302,6 +622,10 @@ void lcd_init(void) {
 	HAL_GPIO_WritePin(FSMC_RES_GPIO_Port, FSMC_RES_Pin, GPIO_PIN_SET);
 	HAL_Delay(500);
 	lcd_set_direction(DFT_SCAN_DIR);
+	HAL_DMA_RegisterCallback(&hdma_memtomem_dma2_stream1,
+			HAL_DMA_XFER_CPLT_CB_ID, lcd_dma_xfer_cplt);
+	HAL_DMA_RegisterCallback(&hdma_memtomem_dma2_stream1,
+			HAL_DMA_XFER_ERROR_CB_ID, lcd_dma_xfer_error);
 	LCD_WR_REG(0XD3);
 	lcddev.id = LCD_RD_DATA();
 	lcddev.id = LCD_RD_DATA();
@@ -423,25 +747,123 @@ static void _draw_circle_8(int xc, int yc, int x, int y, uint16_t c) {
 	lcd_draw_point(xc - y, yc - x, c);
 }
 
+/**
+ * @brief  Half-width of each row of a filled circle
+ * @param  r Radius
+ * @param  half Output, half[dy] for row offsets 0..r
+ * @note   Walks the same midpoint circle as the 8-way fill so the pixel set
+ *         is identical; only the order and the number of writes change
+ */
+static void circle_build_spans(int r, uint16_t *half) {
+	int x = 0, y = r, yi, d = 3 - 2 * r;
+	memset(half, 0, (r + 1) * sizeof(half[0]));
+	while (x <= y) {
+		if (half[x] < y)
+			half[x] = y;
+		for (yi = x; yi <= y; yi++) {
+			if (half[yi] < x)
+				half[yi] = x;
+		}
+		if (d < 0) {
+			d = d + 4 * x + 6;
+		} else {
+			d = d + 4 * (x - y) + 10;
+			y--;
+		}
+		x++;
+	}
+}
+
+/**
+ * @brief  Row half-widths of a filled circle
+ * @param  r Radius
+ * @retval half[dy] for row offsets 0..r, or NULL if r is out of range
+ * @note   Tables for small radii are cached; larger ones share a scratch
+ *         buffer that the next call overwrites
+ */
+const uint16_t* lcd_circle_spans(int r) {
+	if (r < 0)
+		return NULL;
+	if (r <= LCD_CIRCLE_CACHE_R) {
+		if (!(circle_span_cached & (1UL << r))) {
+			circle_build_spans(r, circle_span_cache[r]);
+			circle_span_cached |= 1UL << r;
+		}
+		return circle_span_cache[r];
+	}
+	if (r <= LCD_CIRCLE_MAX_R) {
+		circle_build_spans(r, circle_span_scratch);
+		return circle_span_scratch;
+	}
+	return NULL;
+}
+
+/**
+ * @brief  Pixels of a circle outline as one bitmask per row
+ * @param  r Radius, at most 15
+ * @param  rows Output, 2r+1 rows; bit (dx + r) is set when (dx, dy - r) is
+ *         drawn by lcd_draw_circle(..., fill=0)
+ * @retval None
+ */
+void lcd_circle_outline_rows(int r, uint32_t *rows) {
+	int x = 0, y = r, d = 3 - 2 * r;
+	if (r < 0 || r > 15)
+		return;
+	memset(rows, 0, (2 * r + 1) * sizeof(rows[0]));
+	while (x <= y) {
+		rows[r + y] |= 1UL << (r + x) | 1UL << (r - x);
+		rows[r - y] |= 1UL << (r + x) | 1UL << (r - x);
+		rows[r + x] |= 1UL << (r + y) | 1UL << (r - y);
+		rows[r - x] |= 1UL << (r + y) | 1UL << (r - y);
+		if (d < 0) {
+			d = d + 4 * x + 6;
+		} else {
+			d = d + 4 * (x - y) + 10;
+			y--;
+		}
+		x++;
+	}
+}
+
+/**
+ * @brief  Draw a filled circle, one horizontal span per scanline
+ * @param  xc X coordinate of the center
+ * @param  yc Y coordinate of the center
+ * @param  r Radius
+ * @param  c Color
+ * @retval None
+ */
+void lcd_fill_circle(int xc, int yc, int r, uint16_t c) {
+	const uint16_t *spans = lcd_circle_spans(r);
+	int dy;
+
+	if (spans == NULL)
+		return;
+
+	for (dy = -r; dy <= r; dy++) {
+		int y = yc + dy;
+		int w = spans[dy < 0 ? -dy : dy];
+		int x1 = xc - w, x2 = xc + w;
+		if (y < 0 || y >= lcddev.height)
+			continue;
+		if (x1 < 0)
+			x1 = 0;
+		if (x2 >= lcddev.width)
+			x2 = lcddev.width - 1;
+		if (x1 > x2)
+			continue;
+		lcd_fill(x1, y, x2 + 1, y + 1, c);
+	}
+}
+
 void lcd_draw_circle(int xc, int yc, uint16_t c, int r, int fill)
 {
-	int x = 0, y = r, yi, d;
+	int x = 0, y = r, d;
 
 	d = 3 - 2 * r;
 
 	if (fill) {
-		while (x <= y) {
-			for (yi = x; yi <= y; yi++)
-				_draw_circle_8(xc, yc, x, yi, c);
-
-			if (d < 0) {
-				d = d + 4 * x + 6;
-			} else {
-				d = d + 4 * (x - y) + 10;
-				y--;
-			}
-			x++;
-		}
+		lcd_fill_circle(xc, yc, r, c);
 	} else {
 		while (x <= y) {
 			_draw_circle_8(xc, yc, x, y, c);
@@ -456,27 +878,40 @@ void lcd_draw_circle(int xc, int yc, uint16_t c, int r, int fill)
 	}
 }
 
+/**
+ * @brief  Draw a string, each line in as few address windows as its mode
+ *         allows (see lcd_show_text_line)
+ * @param  x X coordinate
+ * @param  y Y coordinate
+ * @param  str String; '\r' starts a new line, other characters missing
+ *         from the font are skipped
+ * @param  fc Foreground color
+ * @param  bc Background color, unused in transparent mode
+ * @param  sizey Font height: 12, 16, 24 or 32
+ * @param  mode 0: opaque, 1: transparent
+ * @note   Text is cut at the right and bottom edges of the screen
+ * @retval None
+ */
 void lcd_show_string(uint16_t x, uint16_t y, char *str, uint16_t fc, uint16_t bc,
 		uint8_t sizey, uint8_t mode) {
-	uint16_t x0 = x;
-	uint8_t bHz = 0;
+	char line[LCD_TEXT_MAX_CHARS];
+	uint16_t sizex = sizey / 2;
+	uint16_t count;
 	while (*str != 0) {
-		if (!bHz) {
-			if (x > (lcddev.width - sizey / 2) || y > (lcddev.height - sizey))
-				return;
-			if (*str > 0x80)
-				bHz = 1;
-			else {
-				if (*str == 0x0D) {
-					y += sizey;
-					x = x0;
-					str++;
-				} else {
-					lcd_show_char(x, y, *str, fc, bc, sizey, mode);
-					x += sizey / 2;
-				}
-				str++;
-			}
+		if (y > (lcddev.height - sizey))
+			return;
+		count = 0;
+		for (; *str != 0 && *str != 0x0D; str++) {
+			if (lcd_glyph(*str, sizey) == NULL || count == LCD_TEXT_MAX_CHARS)
+				continue;
+			if (x + count * sizex > lcddev.width - sizex)
+				continue;
+			line[count++] = *str;
+		}
+		lcd_show_text_line(x, y, line, count, fc, bc, sizey, mode);
+		if (*str == 0x0D) {
+			y += sizey;
+			str++;
 		}
 	}
 }
@@ -4,7 +4,8 @@
 
 /* Includes */
 #include <led_7seg.h>
-#include "spi.h"
+#include "main.h"
+#include "spi_bus.h"
 
 /* Variables */
 static uint8_t led_7seg[4] = { 0, 1, 2, 3 };
@@ -26,7 +27,7 @@ void led_7seg_init() {
 /**
  * @brief	Scan led 7 segment
  * @param	None
- * @note	Call in 1ms interrupt
+ * @note	Call in 1ms interrupt; the word is queued on SPI1, not sent here
  * @retval 	None
  */
 void led_7seg_display() {
@@ -56,9 +57,8 @@ void led_7seg_display() {
 
 	led_7seg_index = (led_7seg_index + 1) % 4;
 
-	HAL_GPIO_WritePin(LD_LATCH_GPIO_Port, LD_LATCH_Pin, 0);
-	HAL_SPI_Transmit(&hspi1, (void*) &spi_buffer, 2, 1);
-	HAL_GPIO_WritePin(LD_LATCH_GPIO_Port, LD_LATCH_Pin, 1);
+	// The bus manager frames the transfer with LD_LATCH
+	spi_bus_submit(SPI_BUS_LED_7SEG, spi_buffer, NULL);
 }
 
 /**
@@ -33,9 +33,17 @@
 #include "lcd.h"
 #include "ds3231.h"
 #include "button.h"
+#include "led_7seg.h"
 #include "picture.h"
 #include "game_ui.h"
 #include "game_logic.h"
+#include "frame_scheduler.h"
+#include "profiler.h"
+#include "session.h"
+#include "input.h"
+#include "potentiometer.h"
+#include "spi_bus.h"
+#include "console.h"
 #include <stdio.h>
 /* USER CODE END Includes */
 
@@ -70,6 +78,7 @@ GameState game_state;
 void SystemClock_Config(void);
 /* USER CODE BEGIN PFP */
 void system_init();
+static void report_print(const char *line);
 /* USER CODE END PFP */
 
 /* Private user code ---------------------------------------------------------*/
@@ -114,7 +123,8 @@ int main(void)
   MX_ADC1_Init();
   /* USER CODE BEGIN 2 */
 	system_init();
-	timer2_set(20); // ~50 FPS ~ 20ms
+	frame_scheduler_init();
+	profiler_init();
 	game_state.status = GAME_START_SCREEN;
 	// Display Intro Screen (Background Image + "PRESS BUTTON 1 TO PLAY")
 	lcd_show_picture(0, 0, 240, 320, gImage_BK);
@@ -124,55 +134,120 @@ int main(void)
   /* Infinite loop */
   /* USER CODE BEGIN WHILE */
 	while (1) {
-		button_scan();
+		// One pass per button scan (BUTTON_SCAN_MS): the read itself runs
+		// on SPI DMA from the timer interrupt
+		uint16_t held;
+		if (!button_take(&held))
+			continue;
+		PROFILE_BEGIN(PROF_ZONE_BUTTON_SCAN);
+		input_update(session_buttons(held)); // recorded, or replayed
+		uint8_t pot = session_pot(potentiometer_read()); // filtered by the ADC DMA interrupt
+		uint16_t pressed = 0;
+		input_event_t event;
+		while (input_pop(&event)) {
+			if (event.type == INPUT_PRESS)
+				pressed |= 1u << event.button;
+		}
+		PROFILE_END(PROF_ZONE_BUTTON_SCAN);
+		if (console_room() >= CONSOLE_TX_SIZE / 2)
+			session_export(report_print, SESSION_EXPORT_LINE); // stream the recording out as it grows
+		uint8_t drawn = 0; // this pass put a frame on the LCD
 
 		switch (game_state.status) {
 		case GAME_START_SCREEN:
-			if (button_count[0] == 1) { // Change from Intro to Playing Screen
+			if (pressed & (1u << 0)) { // Change from Intro to Playing Screen
+				// Record from here unless a loaded session is being replayed
+				uint32_t seed = session.seed;
+				if (session.mode != SESSION_REPLAYING) {
+					seed = HAL_GetTick();
+					session_record_start(seed);
+				}
+				input_init(NULL); // sessions start from released buttons
+				game_seed(&game_state, seed);
 				game_init_state(&game_state);
 				game_state.show_potentiometer_prompt = 1;
 				game_state.status = GAME_PLAYING;
 				game_draw_initial_scene(&game_state);
+				drawn = 1;
 			}
 			break;
 		case GAME_PLAYING:
-			if (!game_state.show_potentiometer_prompt && timer2_flag == 1) { // Game Update over ~50 FPS
-				step_world(&game_state, 0.02f); // Assuming dt = 0.02 seconds for ~50 FPS
-				timer2_flag = 0;
-				game_update_screen(&game_state); // only updates changed components like paddle  and ball
+			if (!game_state.show_potentiometer_prompt) {
+				// Catch the simulation up with real time, then draw once
+				PROFILE_BEGIN(PROF_ZONE_FRAME);
+				uint8_t steps = session_steps(frame_scheduler_poll());
+				for (uint8_t i = 0; i < steps; i++) {
+					game_handle_paddle_pot(&game_state, pot);
+					game_handle_paddle_buttons(&game_state);
+					PROFILE_BEGIN(PROF_ZONE_STEP_WORLD);
+					step_world(&game_state, FIX16_FROM_MS(FRAME_STEP_MS));
+					PROFILE_END(PROF_ZONE_STEP_WORLD);
+					if (game_state.status != GAME_PLAYING || game_state.show_potentiometer_prompt)
+						break; // game over or ball lost: stop until the player reacts
+				}
+				if (steps > 0) {
+					PROFILE_BEGIN(PROF_ZONE_UPDATE_SCREEN);
+					game_render_events(&game_state); // LCD work the steps queued, batched
+					if (game_state.status == GAME_PLAYING && !game_state.show_potentiometer_prompt)
+						game_update_screen(&game_state); // only updates changed components like paddle  and ball
+					PROFILE_END(PROF_ZONE_UPDATE_SCREEN);
+					drawn = 1;
+					PROFILE_END(PROF_ZONE_FRAME);
+				}
 			}
-			if (game_state.show_potentiometer_prompt && button_count[2] == 1) { // Start Game after showing prompt, 
-																				// use potentiometer check  in the future
+			if (game_state.show_potentiometer_prompt
+					&& ((pressed & (1u << 2)) || game_handle_paddle_pot(&game_state, pot))) { // Start Game after showing prompt:
+																								// button 2 or a turn of the knob
 				game_state.show_potentiometer_prompt = 0;
 				initialize_ball_velocity(&game_state.balls[0]);		
 				game_draw_initial_scene(&game_state);
+				frame_scheduler_resync();
+				drawn = 1;
 			}
 
-			if (button_count[4] == 1) { // Pause Button
+			if (pressed & (1u << 4)) { // Pause Button
 				game_state.status = GAME_PAUSED;
 				game_draw_pause_screen(&game_state);
-			} else if (button_count[5] == 1) { // Game Over Button
+				profiler_dump(report_print); // report the play session so far
+				spi_bus_dump(report_print);
+				printf("input presses=%lu avg_ms=%lu max_ms=%lu stale=%lu\r\n",
+						(unsigned long) input_latency.count,
+						(unsigned long) (input_latency.count ? input_latency.total / input_latency.count : 0),
+						(unsigned long) input_latency.max,
+						(unsigned long) input_latency.stale);
+				session_export(report_print, 0);
+				printf("session exported=%lu dropped=%lu\r\n",
+						(unsigned long) session.exported,
+						(unsigned long) session.dropped);
+				drawn = 1;
+			} else if (pressed & (1u << 5)) { // Game Over Button
 				game_state.status = GAME_OVER;
 				game_draw_game_over_screen(&game_state);
+				drawn = 1;
 			}
 			break;
 		case GAME_PAUSED:
-			if (button_count[4] == 1) { // Resume Button
+			if (pressed & (1u << 4)) { // Resume Button
 				game_state.status = GAME_PLAYING;
 				game_draw_initial_scene(&game_state);
+				frame_scheduler_resync(); // paused time is not owed
+				drawn = 1;
 			}
 			break;
 		case GAME_OVER:
-			if (button_count[5] == 1) { // Restart Game from Game Over
+			if (pressed & (1u << 5)) { // Restart Game from Game Over
 				game_init_state(&game_state);
 				game_state.status = GAME_PLAYING;
 				game_state.show_potentiometer_prompt = 1;
 				game_draw_initial_scene(&game_state);
+				drawn = 1;
 			}
 			break;
 		default:
 			break;
 		}
+		if (drawn)
+			input_frame_presented(); // closes the press-to-screen latency
     /* USER CODE END WHILE */
 
     /* USER CODE BEGIN 3 */
@@ -227,15 +302,37 @@ void SystemClock_Config(void)
 }
 
 /* USER CODE BEGIN 4 */
+/**
+ * @brief  	printf() retarget (_write() in syscalls.c): the USART1 debug console
+ */
+int __io_putchar(int ch) {
+	console_putc((char) ch);
+	return ch;
+}
+
+/**
+ * @brief  	Profiler, SPI1 bus and session report sink: one line to the debug console via printf
+ */
+static void report_print(const char *line) {
+	printf("%s\r\n", line);
+}
+
 void system_init() {
 	HAL_GPIO_WritePin(OUTPUT_Y0_GPIO_Port, OUTPUT_Y0_Pin, 0);
 	HAL_GPIO_WritePin(OUTPUT_Y1_GPIO_Port, OUTPUT_Y1_Pin, 0);
 	HAL_GPIO_WritePin(DEBUG_LED_GPIO_Port, DEBUG_LED_Pin, 0);
 
+	console_init(); // printf() output, before anything reports
 	lcd_init();
 	ds3231_init();
+	spi_bus_init();
+	button_init();
+	led_7seg_init();
+	input_init(NULL);
 
 	timer2_init();
+	potentiometer_init(); // conversions are triggered by TIM2
+	timer4_init(); // 7-segment refresh, shares SPI1 with the button scan
 }
 /* USER CODE END 4 */
 
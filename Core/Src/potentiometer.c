@@ -0,0 +1,102 @@
+/*
+ * potentiometer.c
+ *
+ * Each block of samples goes through a median of three (drops single-sample
+ * spikes) and a first-order IIR in Q4 (alpha = 1/4, about 4 ms at 1 kHz).
+ * The filtered 12-bit reading is cut to POTENTIOMETER_POSITION_MAX + 1
+ * positions with hysteresis, so a resting knob never changes position.
+ */
+
+/* Includes */
+#include "potentiometer.h"
+#include "adc.h"
+
+/* Defines */
+#define POTENTIOMETER_IIR_SHIFT 2
+#define POTENTIOMETER_STEP_Q4 ((4096u << 4) / (POTENTIOMETER_POSITION_MAX + 1))
+#define POTENTIOMETER_HYSTERESIS_Q4 (POTENTIOMETER_STEP_Q4 / 4)
+
+/* Variables */
+uint32_t potentiometer_blocks = 0;
+
+static uint16_t potentiometer_ring[POTENTIOMETER_RING_SCANS * POTENTIOMETER_CHANNELS];
+static uint16_t potentiometer_history[2];	// previous two raw samples
+static int32_t potentiometer_iir = 0;		// filtered reading, Q4
+static uint8_t potentiometer_primed = 0;
+static volatile uint8_t potentiometer_position = POTENTIOMETER_POSITION_MAX / 2;
+
+/* Functions */
+/**
+ * @brief  	Start the timer-triggered ADC1 sequence into the DMA ring
+ * @param  	None
+ * @note  	TIM2 must be running; its update event triggers each sequence
+ * @retval 	None
+ */
+void potentiometer_init(void) {
+	potentiometer_primed = 0;
+	HAL_ADC_Start_DMA(&hadc1, (void*) potentiometer_ring,
+			POTENTIOMETER_RING_SCANS * POTENTIOMETER_CHANNELS);
+}
+
+/**
+ * @brief  	Latest filtered position
+ * @param  	None
+ * @retval 	0 (fully left) to POTENTIOMETER_POSITION_MAX (fully right)
+ */
+uint8_t potentiometer_read(void) {
+	return potentiometer_position;
+}
+
+static uint16_t median3(uint16_t a, uint16_t b, uint16_t c) {
+	if (a > b) {
+		uint16_t t = a;
+		a = b;
+		b = t;
+	}
+	if (b > c)
+		b = c;
+	return a > b ? a : b;
+}
+
+/**
+ * @brief  	Filter one half of the ring and publish the new position
+ * @param  	scans First scan of the half
+ * @retval 	None
+ */
+static void potentiometer_filter(const uint16_t *scans) {
+	for (uint8_t i = 0; i < POTENTIOMETER_RING_SCANS / 2; i++) {
+		uint16_t raw = scans[i * POTENTIOMETER_CHANNELS + POTENTIOMETER_RANK];
+		if (!potentiometer_primed) {
+			potentiometer_history[0] = raw;
+			potentiometer_history[1] = raw;
+			potentiometer_iir = (int32_t) raw << 4;
+			potentiometer_primed = 1;
+		}
+		uint16_t m = median3(potentiometer_history[0], potentiometer_history[1], raw);
+		potentiometer_history[0] = potentiometer_history[1];
+		potentiometer_history[1] = raw;
+		potentiometer_iir += (((int32_t) m << 4) - potentiometer_iir)
+				>> POTENTIOMETER_IIR_SHIFT;
+	}
+
+	// Move only once the reading is clearly past the current position
+	int32_t center = potentiometer_position * (int32_t) POTENTIOMETER_STEP_Q4
+			+ POTENTIOMETER_STEP_Q4 / 2;
+	int32_t distance = potentiometer_iir - center;
+	if (distance < 0)
+		distance = -distance;
+	if (distance > (int32_t) (POTENTIOMETER_STEP_Q4 / 2 + POTENTIOMETER_HYSTERESIS_Q4))
+		potentiometer_position = (uint8_t) (potentiometer_iir / POTENTIOMETER_STEP_Q4);
+	potentiometer_blocks++;
+}
+
+void HAL_ADC_ConvHalfCpltCallback(ADC_HandleTypeDef *hadc) {
+	if (hadc == &hadc1)
+		potentiometer_filter(&potentiometer_ring[0]);
+}
+
+void HAL_ADC_ConvCpltCallback(ADC_HandleTypeDef *hadc) {
+	if (hadc == &hadc1)
+		potentiometer_filter(&potentiometer_ring[POTENTIOMETER_RING_SCANS / 2
+				* POTENTIOMETER_CHANNELS]);
+}
@@ -0,0 +1,151 @@
+/*
+ * profiler.c
+ */
+
+/* Includes */
+#include "profiler.h"
+
+#if PROFILER_ENABLED
+
+#include "main.h"
+#include <stdio.h>
+
+#ifdef HOST_BUILD
+#include <time.h>
+#define PROFILER_TICKS_PER_US 1000u	// host ticks are nanoseconds
+#define PROFILER_LOCK() do { } while (0)
+#define PROFILER_UNLOCK() do { } while (0)
+#else
+#define PROFILER_TICKS_PER_US (SystemCoreClock / 1000000u)
+// The timer ISR records too, so ring and stats updates run with IRQs masked
+#define PROFILER_LOCK() uint32_t profiler_primask = __get_PRIMASK(); __disable_irq()
+#define PROFILER_UNLOCK() __set_PRIMASK(profiler_primask)
+#endif
+
+/* Variables */
+profiler_stats_t profiler_stats[PROF_ZONE_COUNT];
+profiler_sample_t profiler_ring[PROFILER_RING_SIZE];
+uint16_t profiler_ring_head = 0;
+
+static const char *const zone_names[PROF_ZONE_COUNT] = {
+	"frame", "button_scan", "step_world", "update_screen", "timer_isr"
+};
+
+/* Functions */
+/**
+ * @brief  	Start the cycle counter and clear all statistics
+ * @param  	None
+ * @retval 	None
+ */
+void profiler_init(void) {
+#ifndef HOST_BUILD
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->CYCCNT = 0;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+#endif
+	profiler_reset();
+}
+
+/**
+ * @brief  	Clear all statistics and the sample ring
+ * @param  	None
+ * @retval 	None
+ */
+void profiler_reset(void) {
+	PROFILER_LOCK();
+	for (uint8_t i = 0; i < PROF_ZONE_COUNT; i++) {
+		profiler_stats_t *s = &profiler_stats[i];
+		s->count = 0;
+		s->min = UINT32_MAX;
+		s->max = 0;
+		s->total = 0;
+		for (uint8_t b = 0; b < PROFILER_HIST_BUCKETS; b++)
+			s->hist[b] = 0;
+	}
+	for (uint16_t i = 0; i < PROFILER_RING_SIZE; i++) {
+		profiler_ring[i].zone = 0;
+		profiler_ring[i].ticks = 0;
+	}
+	profiler_ring_head = 0;
+	PROFILER_UNLOCK();
+}
+
+/**
+ * @brief  	Read the free-running tick counter; differences wrap correctly
+ * @param  	None
+ * @retval 	Cycles on the target, nanoseconds on the host
+ */
+uint32_t profiler_now(void) {
+#ifdef HOST_BUILD
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint32_t) ((uint64_t) ts.tv_sec * 1000000000u + (uint64_t) ts.tv_nsec);
+#else
+	return DWT->CYCCNT;
+#endif
+}
+
+/**
+ * @brief  	Add one zone sample to the statistics, histogram and ring
+ * @param  	zone Zone that was timed
+ * @param  	ticks Elapsed profiler_now() ticks
+ * @retval 	None
+ */
+void profiler_record(profiler_zone_t zone, uint32_t ticks) {
+	uint32_t us = ticks / PROFILER_TICKS_PER_US;
+	uint8_t bucket = us == 0 ? 0 : (uint8_t) (32 - __builtin_clz(us));
+	if (bucket >= PROFILER_HIST_BUCKETS)
+		bucket = PROFILER_HIST_BUCKETS - 1;
+
+	PROFILER_LOCK();
+	profiler_stats_t *s = &profiler_stats[zone];
+	s->count++;
+	s->total += ticks;
+	if (ticks < s->min)
+		s->min = ticks;
+	if (ticks > s->max)
+		s->max = ticks;
+	s->hist[bucket]++;
+
+	profiler_ring[profiler_ring_head].zone = (uint8_t) zone;
+	profiler_ring[profiler_ring_head].ticks = ticks;
+	profiler_ring_head = (profiler_ring_head + 1) % PROFILER_RING_SIZE;
+	PROFILER_UNLOCK();
+}
+
+/**
+ * @brief  	Format ticks as microseconds with two decimals
+ */
+static void format_us(char *buf, size_t size, uint64_t ticks) {
+	uint64_t centi = ticks * 100u / PROFILER_TICKS_PER_US;
+	snprintf(buf, size, "%lu.%02u", (unsigned long) (centi / 100u),
+			(unsigned) (centi % 100u));
+}
+
+/**
+ * @brief  	Write the per-zone report, one line per call of out
+ * @param  	out Line sink, e.g. printf to the debug console
+ * @retval 	None
+ */
+void profiler_dump(profiler_output_t out) {
+	char line[160];
+	char min[24], avg[24], max[24];
+
+	out("zone          count     min_us    avg_us    max_us    hist(<1us,<2,<4,..)");
+	for (uint8_t i = 0; i < PROF_ZONE_COUNT; i++) {
+		const profiler_stats_t *s = &profiler_stats[i];
+		if (s->count == 0)
+			continue;
+		format_us(min, sizeof(min), s->min);
+		format_us(avg, sizeof(avg), s->total / s->count);
+		format_us(max, sizeof(max), s->max);
+		int n = snprintf(line, sizeof(line), "%-13s %-9lu %-9s %-9s %-9s ",
+				zone_names[i], (unsigned long) s->count, min, avg, max);
+		for (uint8_t b = 0; b < PROFILER_HIST_BUCKETS && n < (int) sizeof(line); b++)
+			n += snprintf(line + n, sizeof(line) - n, b ? ",%lu" : "%lu",
+					(unsigned long) s->hist[b]);
+		out(line);
+	}
+}
+
+#endif /* PROFILER_ENABLED */
@@ -0,0 +1,233 @@
+/*
+ * session.c
+ */
+
+/* Includes */
+#include "session.h"
+#include "frame_scheduler.h"
+#include <stdio.h>
+
+#if FRAME_MAX_SUBSTEPS >= SESSION_STEPS_POT
+#error "session entries hold at most 6 steps per tick"
+#endif
+
+/* Variables */
+session_t session;
+
+/* Functions */
+static void session_reset(session_mode_t mode, uint32_t seed) {
+	session.mode = mode;
+	session.seed = seed;
+	session.head = 0;
+	session.tail = 0;
+	session.count = 0;
+	session.dropped = 0;
+	session.run_repeat = 0;
+	session.tick_open = 0;
+	session.pot = SESSION_POT_NONE;
+	session.exported = 0;
+}
+
+/**
+ * @brief  	Move the current run into the ring
+ * @param  	None
+ * @retval 	None
+ */
+static void session_flush_run(void) {
+	if (session.run_repeat == 0)
+		return;
+	if (!session_push(SESSION_ENTRY(session.run_buttons, session.run_steps,
+			session.run_repeat)))
+		session.dropped++;
+	session.run_repeat = 0;
+}
+
+/**
+ * @brief  	Add the finished tick to the current run, or start a new run
+ * @param  	None
+ * @retval 	None
+ */
+static void session_close_tick(void) {
+	if (!session.tick_open)
+		return;
+	session.tick_open = 0;
+	if (session.run_repeat > 0 && session.run_repeat < SESSION_REPEAT_MAX
+			&& session.run_buttons == session.tick_buttons
+			&& session.run_steps == session.tick_steps) {
+		session.run_repeat++;
+		return;
+	}
+	session_flush_run();
+	session.run_buttons = session.tick_buttons;
+	session.run_steps = session.tick_steps;
+	session.run_repeat = 1;
+}
+
+/**
+ * @brief  	Start recording ticks; the game must be seeded with seed
+ * @param  	seed Seed given to game_seed()
+ * @retval 	None
+ */
+void session_record_start(uint32_t seed) {
+	session_reset(SESSION_RECORDING, seed);
+}
+
+/**
+ * @brief  	Start replaying; load entries with session_push() before and
+ *          while ticks are consumed
+ * @param  	seed Seed the recording was made with
+ * @retval 	None
+ */
+void session_replay_start(uint32_t seed) {
+	session_reset(SESSION_REPLAYING, seed);
+}
+
+/**
+ * @brief  	End the session; a recording's last run is moved into the ring
+ * @param  	None
+ * @retval 	None
+ */
+void session_stop(void) {
+	if (session.mode == SESSION_RECORDING) {
+		session_close_tick();
+		session_flush_run();
+	}
+	session.mode = SESSION_OFF;
+}
+
+/**
+ * @brief  	Start a tick: record the live buttons, or replace them with the
+ *          recorded ones
+ * @param  	live Held buttons read from the hardware (button_take())
+ * @note  	Call once per main-loop tick, before anything reads the input.
+ *          Replay falls back to live input when the entries run out.
+ * @retval 	Buttons to pass to input_update()
+ */
+uint16_t session_buttons(uint16_t live) {
+	if (session.mode == SESSION_RECORDING) {
+		session_close_tick();
+		session.tick_buttons = live;
+		session.tick_steps = 0;
+		session.tick_open = 1;
+		return live;
+	}
+	if (session.mode == SESSION_REPLAYING) {
+		while (session.run_repeat == 0) {
+			session_entry_t entry;
+			if (session_pop(&entry, 1) == 0) {
+				session.mode = SESSION_OFF;
+				return live;
+			}
+			if (SESSION_ENTRY_STEPS(entry) == SESSION_STEPS_POT) {
+				session.pot = SESSION_ENTRY_BUTTONS(entry);
+				continue;
+			}
+			session.run_buttons = SESSION_ENTRY_BUTTONS(entry);
+			session.run_steps = SESSION_ENTRY_STEPS(entry);
+			session.run_repeat = SESSION_ENTRY_REPEAT(entry);
+		}
+		session.run_repeat--;
+		return session.run_buttons;
+	}
+	return live;
+}
+
+/**
+ * @brief  	Record the steps granted this tick, or replace them with the
+ *          recorded count
+ * @param  	live Steps from frame_scheduler_poll()
+ * @note  	Call at most once per tick; ticks that never poll record 0
+ * @retval 	Steps to run
+ */
+uint8_t session_steps(uint8_t live) {
+	if (session.mode == SESSION_RECORDING) {
+		session.tick_steps = live;
+		return live;
+	}
+	if (session.mode == SESSION_REPLAYING)
+		return session.run_steps;
+	return live;
+}
+
+/**
+ * @brief  	Record the potentiometer position when it changed, or replace it
+ *          with the replayed one
+ * @param  	live Position from potentiometer_read()
+ * @note  	Call once per tick, after session_buttons()
+ * @retval 	Position to use
+ */
+uint8_t session_pot(uint8_t live) {
+	if (session.mode == SESSION_RECORDING) {
+		if (live != session.pot) {
+			// Ticks so far go first, so replay applies the marker on this tick
+			session_flush_run();
+			if (!session_push(SESSION_ENTRY_POT(live)))
+				session.dropped++;
+			session.pot = live;
+		}
+		return live;
+	}
+	if (session.mode == SESSION_REPLAYING && session.pot != SESSION_POT_NONE)
+		return (uint8_t) session.pot;
+	return live;
+}
+
+/**
+ * @brief  	Append an entry to the ring
+ * @param  	entry Entry to store
+ * @retval 	1 if stored, 0 if the ring is full
+ */
+uint8_t session_push(session_entry_t entry) {
+	if (session.count == SESSION_LOG_SIZE)
+		return 0;
+	session.log[session.head] = entry;
+	session.head = (session.head + 1) % SESSION_LOG_SIZE;
+	session.count++;
+	return 1;
+}
+
+/**
+ * @brief  	Take the oldest entries out of the ring, e.g. to save a recording
+ * @param  	entries Destination
+ * @param  	max Room in entries
+ * @retval 	Number of entries taken
+ */
+uint16_t session_pop(session_entry_t *entries, uint16_t max) {
+	uint16_t n = 0;
+	while (n < max && session.count > 0) {
+		entries[n++] = session.log[session.tail];
+		session.tail = (session.tail + 1) % SESSION_LOG_SIZE;
+		session.count--;
+	}
+	return n;
+}
+
+/**
+ * @brief  	Drain a recording's ring as text, for targets with no file to
+ *          save it to: a "session seed=" line first, then hex entries,
+ *          SESSION_EXPORT_LINE per "session" line, oldest first
+ * @param  	out Line sink
+ * @param  	min Entries the ring must hold before anything is drained
+ * @note  	Does nothing unless recording; a replay consumes its own ring
+ * @retval 	None
+ */
+void session_export(session_output_t out, uint16_t min) {
+	if (session.mode != SESSION_RECORDING || session.count == 0
+			|| session.count < min)
+		return;
+	char line[8 + SESSION_EXPORT_LINE * 9 + 1];
+	if (session.exported == 0) {
+		snprintf(line, sizeof(line), "session seed=%lu", (unsigned long) session.seed);
+		out(line);
+	}
+	session_entry_t entries[SESSION_EXPORT_LINE];
+	uint16_t n;
+	while ((n = session_pop(entries, SESSION_EXPORT_LINE)) > 0) {
+		int len = snprintf(line, sizeof(line), "session");
+		for (uint16_t i = 0; i < n; i++)
+			len += snprintf(line + len, sizeof(line) - len, " %08lx",
+					(unsigned long) entries[i]);
+		out(line);
+		session.exported += n;
+	}
+}
@@ -7,12 +7,10 @@
 #include "tim.h"
 
 #include "led_7seg.h"
+#include "button.h"
+#include "profiler.h"
 
 /* Variables */
-uint8_t timer2_flag = 0;
-uint16_t timer2_counter = 0;
-uint16_t timer2_mul = 0;
-
 uint8_t timer4_flag = 0;
 uint16_t timer4_counter = 0;
 uint16_t timer4_mul = 0;
@@ -35,12 +33,6 @@ void timer4_init(void) {
  * @param	duration Duration of software timer interrupt
  * @retval 	None
  */
-void timer2_set(int ms) {
-	timer2_mul = ms / TIMER_CYCLE_2;
-	timer2_counter = timer2_mul;
-	timer2_flag = 0;
-}
-
 void timer4_set(int ms) {
 	timer4_mul = ms / TIMER_CYCLE_4;
 	timer4_counter = timer4_mul;
@@ -54,14 +46,9 @@ void timer4_set(int ms) {
  * @retval 	None
  */
 void HAL_TIM_PeriodElapsedCallback(TIM_HandleTypeDef *htim) {
+	PROFILE_BEGIN(PROF_ZONE_TIMER_ISR);
 	if (htim->Instance == TIM2) {
-		if (timer2_counter > 0) {
-			timer2_counter--;
-			if (timer2_counter == 0) {
-				timer2_flag = 1;
-				timer2_counter = timer2_mul;
-			}
-		}
+		button_timer_tick();
 	}
 
 	if (htim->Instance == TIM4) {
@@ -75,5 +62,6 @@ void HAL_TIM_PeriodElapsedCallback(TIM_HandleTypeDef *htim) {
 
 		led_7seg_display();
 	}
+	PROFILE_END(PROF_ZONE_TIMER_ISR);
 }
 
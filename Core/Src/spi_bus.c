@@ -0,0 +1,234 @@
+/*
+ * spi_bus.c
+ *
+ * Submitting never blocks: the transfer starts at once when SPI1 is idle,
+ * otherwise it waits in the queue and the completion interrupt of the
+ * transfer ahead of it starts it.
+ */
+
+/* Includes */
+#include "spi_bus.h"
+#include "main.h"
+#include "spi.h"
+#include <stdio.h>
+
+#ifdef HOST_BUILD
+#include <time.h>
+#define SPI_BUS_TICKS_PER_US 1000u	// host ticks are nanoseconds
+#define SPI_BUS_LOCK() do { } while (0)
+#define SPI_BUS_UNLOCK() do { } while (0)
+#else
+#define SPI_BUS_TICKS_PER_US (SystemCoreClock / 1000000u)
+// Both timer interrupts submit and the DMA interrupt completes
+#define SPI_BUS_LOCK() uint32_t spi_bus_primask = __get_PRIMASK(); __disable_irq()
+#define SPI_BUS_UNLOCK() __set_PRIMASK(spi_bus_primask)
+#endif
+
+/* Types */
+typedef struct {
+	uint8_t device;
+	uint16_t word;
+	uint32_t submitted;			// spi_bus_now() at submit
+	spi_bus_done_t done;
+} spi_bus_transaction_t;
+
+/* Variables */
+spi_bus_stats_t spi_bus_stats[SPI_BUS_DEVICE_COUNT];
+
+static spi_bus_transaction_t spi_bus_queue[SPI_BUS_QUEUE_SIZE];
+static uint8_t spi_bus_head = 0;
+static uint8_t spi_bus_count = 0;
+static uint8_t spi_bus_pending[SPI_BUS_DEVICE_COUNT];	// queued or active
+static spi_bus_transaction_t spi_bus_active;
+static uint8_t spi_bus_busy = 0;
+static uint16_t spi_bus_buffer;	// DMA source or destination of the active transfer
+
+static const char *const device_names[SPI_BUS_DEVICE_COUNT] = {
+	"buttons", "led_7seg"
+};
+
+/* Functions */
+static uint32_t spi_bus_now(void) {
+#ifdef HOST_BUILD
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint32_t) ((uint64_t) ts.tv_sec * 1000000000u + ts.tv_nsec);
+#else
+	return DWT->CYCCNT;
+#endif
+}
+
+/**
+ * @brief  	Initialize the bus: latches idle, cycle counter on, stats cleared
+ * @param  	None
+ * @retval 	None
+ */
+void spi_bus_init(void) {
+#ifndef HOST_BUILD
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+#endif
+	HAL_GPIO_WritePin(BTN_LOAD_GPIO_Port, BTN_LOAD_Pin, 1);
+	HAL_GPIO_WritePin(LD_LATCH_GPIO_Port, LD_LATCH_Pin, 1);
+	spi_bus_reset_stats();
+}
+
+/**
+ * @brief  	Drive the device's latch line and start the active transfer
+ * @note  	Called with the bus lock held
+ * @retval 	HAL status of the DMA start
+ */
+static HAL_StatusTypeDef spi_bus_start(void) {
+	spi_bus_buffer = spi_bus_active.word;
+	if (spi_bus_active.device == SPI_BUS_BUTTONS) {
+		// Latch the parallel inputs, then shift them out
+		HAL_GPIO_WritePin(BTN_LOAD_GPIO_Port, BTN_LOAD_Pin, 0);
+		HAL_GPIO_WritePin(BTN_LOAD_GPIO_Port, BTN_LOAD_Pin, 1);
+		return HAL_SPI_Receive_DMA(&hspi1, (void*) &spi_bus_buffer, 2);
+	}
+	// The outputs take the shifted word on the rising edge at completion
+	HAL_GPIO_WritePin(LD_LATCH_GPIO_Port, LD_LATCH_Pin, 0);
+	return HAL_SPI_Transmit_DMA(&hspi1, (void*) &spi_bus_buffer, 2);
+}
+
+/**
+ * @brief  	Start queued transfers until one is running or the queue is empty
+ * @note  	Called with the bus lock held
+ * @retval 	None
+ */
+static void spi_bus_next(void) {
+	while (!spi_bus_busy && spi_bus_count > 0) {
+		spi_bus_active = spi_bus_queue[spi_bus_head];
+		spi_bus_head = (spi_bus_head + 1) % SPI_BUS_QUEUE_SIZE;
+		spi_bus_count--;
+		spi_bus_busy = 1;
+		if (spi_bus_start() != HAL_OK) {
+			if (spi_bus_active.device == SPI_BUS_LED_7SEG)
+				HAL_GPIO_WritePin(LD_LATCH_GPIO_Port, LD_LATCH_Pin, 1);
+			spi_bus_stats[spi_bus_active.device].errors++;
+			spi_bus_pending[spi_bus_active.device] = 0;
+			spi_bus_busy = 0;
+		}
+	}
+}
+
+/**
+ * @brief  	Queue one 16-bit transfer for a device
+ * @param  	device Device whose latch line frames the transfer
+ * @param  	word Word to send (ignored for the buttons, which receive)
+ * @param  	done Called from the DMA interrupt when it finishes, or NULL
+ * @note  	Safe from interrupts; never waits for the bus
+ * @retval 	1 if queued, 0 if the device already has a transfer pending
+ */
+uint8_t spi_bus_submit(spi_bus_device_t device, uint16_t word,
+		spi_bus_done_t done) {
+	uint8_t queued = 0;
+	SPI_BUS_LOCK();
+	spi_bus_stats_t *s = &spi_bus_stats[device];
+	s->submitted++;
+	if (spi_bus_pending[device] || spi_bus_count == SPI_BUS_QUEUE_SIZE) {
+		s->dropped++;
+	} else {
+		if (spi_bus_busy || spi_bus_count > 0)
+			s->contended++;
+		spi_bus_transaction_t *t = &spi_bus_queue[(spi_bus_head + spi_bus_count)
+				% SPI_BUS_QUEUE_SIZE];
+		t->device = device;
+		t->word = word;
+		t->submitted = spi_bus_now();
+		t->done = done;
+		spi_bus_count++;
+		spi_bus_pending[device] = 1;
+		queued = 1;
+		spi_bus_next();
+	}
+	SPI_BUS_UNLOCK();
+	return queued;
+}
+
+/**
+ * @brief  	Finish the active transfer and start the next one
+ * @param  	ok 0 if the transfer failed
+ * @retval 	None
+ */
+static void spi_bus_complete(uint8_t ok) {
+	SPI_BUS_LOCK();
+	spi_bus_transaction_t t = spi_bus_active;
+	spi_bus_stats_t *s = &spi_bus_stats[t.device];
+	if (t.device == SPI_BUS_LED_7SEG)
+		HAL_GPIO_WritePin(LD_LATCH_GPIO_Port, LD_LATCH_Pin, 1);
+	if (ok) {
+		uint32_t latency = spi_bus_now() - t.submitted;
+		s->completed++;
+		s->latency_total += latency;
+		if (latency > s->latency_max)
+			s->latency_max = latency;
+	} else {
+		s->errors++;
+	}
+	uint16_t word = spi_bus_buffer;
+	spi_bus_pending[t.device] = 0;
+	spi_bus_busy = 0;
+	spi_bus_next();
+	SPI_BUS_UNLOCK();
+	if (ok && t.done != NULL)
+		t.done(word);
+}
+
+void HAL_SPI_RxCpltCallback(SPI_HandleTypeDef *hspi) {
+	if (hspi == &hspi1)
+		spi_bus_complete(1);
+}
+
+void HAL_SPI_TxCpltCallback(SPI_HandleTypeDef *hspi) {
+	if (hspi == &hspi1)
+		spi_bus_complete(1);
+}
+
+void HAL_SPI_ErrorCallback(SPI_HandleTypeDef *hspi) {
+	if (hspi == &hspi1)
+		spi_bus_complete(0);
+}
+
+/**
+ * @brief  	Clear the per-device statistics
+ * @param  	None
+ * @retval 	None
+ */
+void spi_bus_reset_stats(void) {
+	SPI_BUS_LOCK();
+	for (uint8_t i = 0; i < SPI_BUS_DEVICE_COUNT; i++) {
+		spi_bus_stats_t *s = &spi_bus_stats[i];
+		s->submitted = 0;
+		s->completed = 0;
+		s->dropped = 0;
+		s->contended = 0;
+		s->errors = 0;
+		s->latency_max = 0;
+		s->latency_total = 0;
+	}
+	SPI_BUS_UNLOCK();
+}
+
+/**
+ * @brief  	Report the per-device statistics, one line per device
+ * @param  	out Line sink
+ * @retval 	None
+ */
+void spi_bus_dump(spi_bus_output_t out) {
+	char line[192];
+	for (uint8_t i = 0; i < SPI_BUS_DEVICE_COUNT; i++) {
+		SPI_BUS_LOCK();
+		spi_bus_stats_t s = spi_bus_stats[i];
+		SPI_BUS_UNLOCK();
+		uint32_t avg = s.completed ? (uint32_t) (s.latency_total / s.completed) : 0;
+		snprintf(line, sizeof(line), "spi1 %-9s submitted=%lu completed=%lu "
+				"dropped=%lu contended=%lu errors=%lu latency_us avg=%lu max=%lu",
+				device_names[i], (unsigned long) s.submitted,
+				(unsigned long) s.completed, (unsigned long) s.dropped,
+				(unsigned long) s.contended, (unsigned long) s.errors,
+				(unsigned long) (avg / SPI_BUS_TICKS_PER_US),
+				(unsigned long) (s.latency_max / SPI_BUS_TICKS_PER_US));
+		out(line);
+	}
+}
@@ -0,0 +1,62 @@
+/*
+ * sprite.c
+ */
+
+/* Includes */
+#include "sprite.h"
+#include "lcd.h"
+
+/* Functions */
+/**
+ * @brief  	Rasterize a filled ball into a sprite
+ * @param  	sprite Sprite to fill
+ * @param  	radius Ball radius
+ * @param  	color Ball color
+ * @note  	Same pixel set as lcd_fill_circle
+ * @retval 	1 on success, 0 if the ball does not fit SPRITE_MAX_SIZE
+ */
+uint8_t sprite_build_ball(Sprite *sprite, uint8_t radius, uint16_t color) {
+	const uint16_t *spans = lcd_circle_spans(radius);
+	uint8_t size = 2 * radius + 1;
+	if (spans == NULL || size > SPRITE_MAX_SIZE)
+		return 0;
+
+	sprite->width = size;
+	sprite->height = size;
+	for (int row = 0; row < size; row++) {
+		int dy = row - radius;
+		uint16_t half = spans[dy < 0 ? -dy : dy];
+		sprite->row_start[row] = radius - half;
+		sprite->row_end[row] = radius + half + 1;
+		for (int col = 0; col < size; col++)
+			sprite->pixels[row * size + col] = color;
+	}
+	return 1;
+}
+
+/**
+ * @brief  	Draw the opaque part of one sprite row over a line buffer
+ * @param  	sprite Sprite
+ * @param  	sx X coordinate of the sprite's top-left corner
+ * @param  	sy Y coordinate of the sprite's top-left corner
+ * @param  	x X coordinate of row[0]
+ * @param  	y Y coordinate of the line
+ * @param  	w Line buffer length
+ * @param  	row Line buffer
+ * @retval 	None
+ */
+void sprite_blend_row(const Sprite *sprite, int16_t sx, int16_t sy,
+		int16_t x, int16_t y, uint16_t w, uint16_t *row) {
+	int line = y - sy;
+	if (line < 0 || line >= sprite->height)
+		return;
+	int from = sx + sprite->row_start[line];
+	int to = sx + sprite->row_end[line];
+	if (from < x)
+		from = x;
+	if (to > x + w)
+		to = x + w;
+	const uint16_t *src = &sprite->pixels[line * sprite->width];
+	for (int i = from; i < to; i++)
+		row[i - x] = src[i - sx];
+}
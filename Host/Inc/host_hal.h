@@ -0,0 +1,22 @@
+/*
+ * host_hal.h
+ *
+ * Controls for the host HAL stand-in: virtual tick, button and potentiometer
+ * injection.
+ */
+
+#ifndef HOST_HAL_H_
+#define HOST_HAL_H_
+
+#include <stdint.h>
+
+// Advance the virtual HAL tick (ms), running the 1 ms timer interrupts
+void host_hal_advance(uint32_t ms);
+
+// Logical buttons (button_decode() numbering) held down; bit n = button n
+void host_hal_set_buttons(uint16_t pressed);
+
+// 12-bit ADC reading of the potentiometer (0..4095)
+void host_hal_set_potentiometer(uint16_t reading);
+
+#endif /* HOST_HAL_H_ */
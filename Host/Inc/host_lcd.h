@@ -0,0 +1,53 @@
+/*
+ * host_lcd.h
+ *
+ * ILI9341 emulator for the host build. lcd.h routes its bus macros here, so
+ * lcd.c drives the same command stream (0x2A/0x2B/0x2C) it sends over FSMC
+ * and the pixels land in a 240x320 RGB565 framebuffer.
+ */
+
+#ifndef HOST_LCD_H_
+#define HOST_LCD_H_
+
+#include <stdint.h>
+
+#define HOST_LCD_WIDTH  240
+#define HOST_LCD_HEIGHT 320
+
+typedef struct {
+	uint16_t LCD_REG;
+	uint16_t LCD_RAM;
+} LCD_TypeDef;
+
+// Same data address as the FSMC bank so DMA code sees the real destination
+#define LCD_BASE        ((uint32_t)(0x60000000 | 0x000ffffe))
+
+#define LCD_BUS_WR_REG(reg)   host_lcd_write_reg(reg)
+#define LCD_BUS_WR_DATA(data) host_lcd_write_data(data)
+#define LCD_BUS_RD_DATA()     host_lcd_read_data()
+
+/* Bus counters */
+typedef struct {
+	uint32_t reg_writes;     // command writes (LCD_REG)
+	uint32_t data_writes;    // every write to LCD_RAM, parameters included
+	uint32_t pixel_writes;   // data writes that landed in GRAM (0x2C)
+	uint32_t window_sets;    // memory write (0x2C) commands issued
+	uint32_t dma_writes;     // data writes issued by a DMA stream, not the CPU
+	uint32_t reads;
+} HostLcdStats;
+
+extern uint16_t host_lcd_framebuffer[HOST_LCD_HEIGHT][HOST_LCD_WIDTH];
+extern HostLcdStats host_lcd_stats;
+
+void host_lcd_write_reg(uint16_t reg);
+void host_lcd_write_data(uint16_t data);
+void host_lcd_dma_write(uint16_t data);
+uint16_t host_lcd_read_data(void);
+
+void host_lcd_reset(void);
+void host_lcd_reset_stats(void);
+uint32_t host_lcd_bus_writes(const HostLcdStats *stats);
+uint32_t host_lcd_checksum(void);
+int host_lcd_save_ppm(const char *path);
+
+#endif /* HOST_LCD_H_ */
@@ -0,0 +1,197 @@
+/*
+ * stm32f4xx_hal.h
+ *
+ * Host stand-in for the STM32F4 HAL. Only the types and calls used by the
+ * game sources are provided; Core/Inc/main.h picks this header up when
+ * Host/Inc is first on the include path.
+ */
+
+#ifndef HOST_STM32F4XX_HAL_H_
+#define HOST_STM32F4XX_HAL_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define __IO volatile
+
+/* Status */
+typedef enum {
+	HAL_OK = 0x00U,
+	HAL_ERROR = 0x01U,
+	HAL_BUSY = 0x02U,
+	HAL_TIMEOUT = 0x03U
+} HAL_StatusTypeDef;
+
+/* GPIO */
+typedef struct {
+	uint16_t odr;
+} GPIO_TypeDef;
+
+typedef enum {
+	GPIO_PIN_RESET = 0,
+	GPIO_PIN_SET
+} GPIO_PinState;
+
+extern GPIO_TypeDef host_gpio[7];
+#define GPIOA (&host_gpio[0])
+#define GPIOB (&host_gpio[1])
+#define GPIOC (&host_gpio[2])
+#define GPIOD (&host_gpio[3])
+#define GPIOE (&host_gpio[4])
+#define GPIOF (&host_gpio[5])
+#define GPIOG (&host_gpio[6])
+
+#define GPIO_PIN_0  ((uint16_t)0x0001)
+#define GPIO_PIN_1  ((uint16_t)0x0002)
+#define GPIO_PIN_2  ((uint16_t)0x0004)
+#define GPIO_PIN_3  ((uint16_t)0x0008)
+#define GPIO_PIN_4  ((uint16_t)0x0010)
+#define GPIO_PIN_5  ((uint16_t)0x0020)
+#define GPIO_PIN_6  ((uint16_t)0x0040)
+#define GPIO_PIN_7  ((uint16_t)0x0080)
+#define GPIO_PIN_8  ((uint16_t)0x0100)
+#define GPIO_PIN_9  ((uint16_t)0x0200)
+#define GPIO_PIN_10 ((uint16_t)0x0400)
+#define GPIO_PIN_11 ((uint16_t)0x0800)
+#define GPIO_PIN_12 ((uint16_t)0x1000)
+#define GPIO_PIN_13 ((uint16_t)0x2000)
+#define GPIO_PIN_14 ((uint16_t)0x4000)
+#define GPIO_PIN_15 ((uint16_t)0x8000)
+
+void HAL_GPIO_WritePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin,
+		GPIO_PinState PinState);
+GPIO_PinState HAL_GPIO_ReadPin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin);
+
+/* Tick */
+uint32_t HAL_GetTick(void);
+void HAL_IncTick(void);
+void HAL_Delay(uint32_t Delay);
+
+/* Clocks and NVIC (no-ops on host) */
+typedef enum {
+	DMA2_Stream0_IRQn = 56,
+	DMA2_Stream1_IRQn = 57,
+	DMA2_Stream2_IRQn = 58,
+	DMA2_Stream3_IRQn = 59
+} IRQn_Type;
+
+#define __HAL_RCC_DMA2_CLK_ENABLE() do { } while (0)
+
+void HAL_NVIC_SetPriority(IRQn_Type IRQn, uint32_t PreemptPriority,
+		uint32_t SubPriority);
+void HAL_NVIC_EnableIRQ(IRQn_Type IRQn);
+
+/* DMA */
+#define DMA2_Stream0 0x40026410U
+#define DMA2_Stream1 0x40026428U
+
+#define DMA_CHANNEL_0              0x00000000U
+#define DMA_PERIPH_TO_MEMORY       0x00000000U
+#define DMA_MEMORY_TO_PERIPH       0x00000040U
+#define DMA_MEMORY_TO_MEMORY       0x00000080U
+#define DMA_PINC_ENABLE            0x00000200U
+#define DMA_PINC_DISABLE           0x00000000U
+#define DMA_MINC_ENABLE            0x00000400U
+#define DMA_MINC_DISABLE           0x00000000U
+#define DMA_PDATAALIGN_HALFWORD    0x00000800U
+#define DMA_MDATAALIGN_HALFWORD    0x00002000U
+#define DMA_NORMAL                 0x00000000U
+#define DMA_CIRCULAR               0x00000100U
+#define DMA_PRIORITY_LOW           0x00000000U
+#define DMA_PRIORITY_HIGH          0x00020000U
+#define DMA_FIFOMODE_DISABLE       0x00000000U
+#define DMA_FIFOMODE_ENABLE        0x00000004U
+#define DMA_FIFO_THRESHOLD_FULL    0x00000003U
+#define DMA_MBURST_SINGLE          0x00000000U
+#define DMA_PBURST_SINGLE          0x00000000U
+
+typedef struct {
+	uint32_t Channel;
+	uint32_t Direction;
+	uint32_t PeriphInc;
+	uint32_t MemInc;
+	uint32_t PeriphDataAlignment;
+	uint32_t MemDataAlignment;
+	uint32_t Mode;
+	uint32_t Priority;
+	uint32_t FIFOMode;
+	uint32_t FIFOThreshold;
+	uint32_t MemBurst;
+	uint32_t PeriphBurst;
+} DMA_InitTypeDef;
+
+typedef enum {
+	HAL_DMA_STATE_RESET = 0x00U,
+	HAL_DMA_STATE_READY = 0x01U,
+	HAL_DMA_STATE_BUSY = 0x02U
+} HAL_DMA_StateTypeDef;
+
+typedef enum {
+	HAL_DMA_XFER_CPLT_CB_ID = 0x00U,
+	HAL_DMA_XFER_HALFCPLT_CB_ID = 0x01U,
+	HAL_DMA_XFER_ERROR_CB_ID = 0x04U
+} HAL_DMA_CallbackIDTypeDef;
+
+typedef struct __DMA_HandleTypeDef {
+	uint32_t Instance;
+	DMA_InitTypeDef Init;
+	volatile HAL_DMA_StateTypeDef State;
+	void *Parent;
+	void (*XferCpltCallback)(struct __DMA_HandleTypeDef *hdma);
+	void (*XferHalfCpltCallback)(struct __DMA_HandleTypeDef *hdma);
+	void (*XferErrorCallback)(struct __DMA_HandleTypeDef *hdma);
+} DMA_HandleTypeDef;
+
+// Addresses are uintptr_t so host pointers survive; uint32_t on the target
+HAL_StatusTypeDef HAL_DMA_Init(DMA_HandleTypeDef *hdma);
+HAL_StatusTypeDef HAL_DMA_Start_IT(DMA_HandleTypeDef *hdma,
+		uintptr_t SrcAddress, uintptr_t DstAddress, uint32_t DataLength);
+HAL_StatusTypeDef HAL_DMA_RegisterCallback(DMA_HandleTypeDef *hdma,
+		HAL_DMA_CallbackIDTypeDef CallbackID,
+		void (*pCallback)(DMA_HandleTypeDef *_hdma));
+void HAL_DMA_IRQHandler(DMA_HandleTypeDef *hdma);
+
+/* Peripheral handles (opaque on host) */
+typedef enum {
+	HAL_SPI_STATE_RESET = 0x00U,
+	HAL_SPI_STATE_READY = 0x01U,
+	HAL_SPI_STATE_BUSY = 0x02U
+} HAL_SPI_StateTypeDef;
+
+typedef struct __SPI_HandleTypeDef {
+	uint32_t Instance;
+} SPI_HandleTypeDef;
+
+typedef struct {
+	uint32_t Instance;
+} SRAM_HandleTypeDef;
+
+typedef struct {
+	uint32_t Instance;
+} TIM_HandleTypeDef;
+
+typedef struct {
+	uint32_t Instance;
+} ADC_HandleTypeDef;
+
+HAL_StatusTypeDef HAL_SPI_Receive(SPI_HandleTypeDef *hspi, uint8_t *pData,
+		uint16_t Size, uint32_t Timeout);
+HAL_StatusTypeDef HAL_SPI_Transmit(SPI_HandleTypeDef *hspi, uint8_t *pData,
+		uint16_t Size, uint32_t Timeout);
+// DMA transfers complete at the end of the emulated millisecond they start in
+HAL_StatusTypeDef HAL_SPI_Receive_DMA(SPI_HandleTypeDef *hspi, uint8_t *pData,
+		uint16_t Size);
+HAL_StatusTypeDef HAL_SPI_Transmit_DMA(SPI_HandleTypeDef *hspi, uint8_t *pData,
+		uint16_t Size);
+HAL_SPI_StateTypeDef HAL_SPI_GetState(SPI_HandleTypeDef *hspi);
+void HAL_SPI_RxCpltCallback(SPI_HandleTypeDef *hspi);
+void HAL_SPI_TxCpltCallback(SPI_HandleTypeDef *hspi);
+void HAL_SPI_ErrorCallback(SPI_HandleTypeDef *hspi);
+
+// Conversions run from host_hal_advance(), one sequence per emulated ms
+HAL_StatusTypeDef HAL_ADC_Start_DMA(ADC_HandleTypeDef *hadc, uint32_t *pData,
+		uint32_t Length);
+void HAL_ADC_ConvHalfCpltCallback(ADC_HandleTypeDef *hadc);
+void HAL_ADC_ConvCpltCallback(ADC_HandleTypeDef *hadc);
+
+#endif /* HOST_STM32F4XX_HAL_H_ */
@@ -0,0 +1,311 @@
+/*
+ * host_bench.c
+ *
+ * Benchmarks for the LCD primitives and for complete game frames, run against
+ * the host build of lcd.c, game_ui.c and game_logic.c. Each case reports the
+ * emulated FSMC bus writes and address-window sets over all its iterations
+ * (exact and repeatable) and host nanoseconds per iteration (machine
+ * dependent).
+ *
+ * Usage: brick_bench [-j out.json] [-b baseline.json] [-r pct] [-T pct]
+ *   -j  write the results as JSON (one benchmark per line) to out.json
+ *   -b  compare with an earlier -j file; exit 1 on a regression
+ *   -r  allowed growth of bus writes / window sets in percent (default 5)
+ *   -T  allowed growth of nanoseconds in percent (default 0 = not checked)
+ */
+
+/* Includes */
+#include "dma.h"
+#include "lcd.h"
+#include "picture.h"
+#include "input.h"
+#include "game_ui.h"
+#include "game_logic.h"
+#include "frame_scheduler.h"
+#include "host_hal.h"
+#include "host_lcd.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define BENCH_MAX 16
+#define GAME_FRAMES 1000
+
+/* Types */
+typedef struct {
+	const char *name;
+	uint32_t iterations;
+	uint32_t bus_writes;	// all iterations
+	uint32_t window_sets;	// all iterations
+	uint64_t ns;			// per iteration
+} BenchResult;
+
+/* Variables */
+static BenchResult results[BENCH_MAX];
+static uint8_t result_count = 0;
+static GameState game_state;
+// One input scan per frame, taken as is: no debounce, hold or repeat
+static const input_config_t frame_input = { .scan_ms = FRAME_STEP_MS };
+
+/* Functions */
+static uint64_t now_ns(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t) ts.tv_sec * 1000000000u + (uint64_t) ts.tv_nsec;
+}
+
+/**
+ * @brief  	Run body iterations times and store its bus counts and time
+ */
+static void bench_run(const char *name, uint32_t iterations,
+		void (*body)(uint32_t i)) {
+	host_lcd_reset_stats();
+	uint64_t start = now_ns();
+	for (uint32_t i = 0; i < iterations; i++)
+		body(i);
+	lcd_dma_wait();
+	uint64_t elapsed = now_ns() - start;
+
+	BenchResult *r = &results[result_count++];
+	r->name = name;
+	r->iterations = iterations;
+	r->bus_writes = host_lcd_bus_writes(&host_lcd_stats);
+	r->window_sets = host_lcd_stats.window_sets;
+	r->ns = elapsed / iterations;
+}
+
+static void bench_fill_screen(uint32_t i) {
+	lcd_fill(0, 0, 240, 320, i & 1 ? BLACK : BLUE);
+}
+
+static void bench_fill_brick(uint32_t i) {
+	lcd_fill(5 + (i % 8) * 29, 40 + (i % 6) * 12, 5 + (i % 8) * 29 + 26,
+			40 + (i % 6) * 12 + 10, RED);
+}
+
+static void bench_draw_circle_ball(uint32_t i) {
+	lcd_draw_circle(20 + i % 200, 160, WHITE, 4, 1);
+}
+
+static void bench_draw_circle_outline(uint32_t i) {
+	lcd_draw_circle(120, 160, i & 1 ? WHITE : GREEN, 60, 0);
+}
+
+static void bench_show_string_opaque(uint32_t i) {
+	lcd_show_string(0, 4 + (i % 8) * 2, "SCORE: 12345  LIVES: 3", WHITE, BLACK,
+			16, 0);
+}
+
+static void bench_show_string_overlay(uint32_t i) {
+	lcd_show_string(10, 100 + (i % 8) * 2, "PRESS BUTTON 1 TO PLAY", WHITE, 0,
+			16, 1);
+}
+
+static void bench_show_picture(uint32_t i) {
+	(void) i;
+	lcd_show_picture(0, 0, 240, 320, gImage_BK);
+}
+
+static void bench_draw_line_diagonal(uint32_t i) {
+	lcd_draw_line(0, i % 100, 239, 319 - i % 100, YELLOW);
+}
+
+static void bench_draw_line_axis(uint32_t i) {
+	lcd_draw_line(0, 30 + i % 200, 239, 30 + i % 200, WHITE);
+	lcd_draw_line(i % 240, 30, i % 240, 319, WHITE);
+}
+
+/**
+ * @brief  	Steer the paddle towards the lowest ball (same idea as brick_host)
+ */
+static uint16_t paddle_autopilot(const GameState *state) {
+	if (state->ball_count == 0)
+		return 0;
+	const Ball *target = &state->balls[0];
+	for (int i = 1; i < state->ball_count; i++) {
+		if (state->balls[i].y > target->y)
+			target = &state->balls[i];
+	}
+	int16_t center = state->paddle.x + state->paddle.width / 2
+			+ ((int16_t) (state->score / 10 % 5) - 2) * 8;
+	if (BALL_PX(target) < center - 4)
+		return 1u << 8;
+	if (BALL_PX(target) > center + 4)
+		return 1u << 9;
+	return 0;
+}
+
+/**
+ * @brief  	One scheduler frame of play: input, physics step, render
+ */
+static void bench_game_frame(uint32_t i) {
+	(void) i;
+	if (game_state.status != GAME_PLAYING)
+		return;
+	input_update(paddle_autopilot(&game_state));
+	input_event_t event;
+	while (input_pop(&event)) {
+	}
+	game_handle_paddle_buttons(&game_state);
+	step_world(&game_state, FIX16_FROM_MS(FRAME_STEP_MS));
+	game_render_events(&game_state);
+	if (game_state.status != GAME_PLAYING)
+		return;
+	if (game_state.show_potentiometer_prompt) {
+		game_state.show_potentiometer_prompt = 0;
+		initialize_ball_velocity(&game_state.balls[0]);
+		game_draw_initial_scene(&game_state);
+	} else {
+		game_update_screen(&game_state);
+	}
+}
+
+static void bench_initial_scene(uint32_t i) {
+	(void) i;
+	game_draw_initial_scene(&game_state);
+}
+
+static void start_game(uint8_t level) {
+	input_init(&frame_input);
+	game_seed(&game_state, 1);
+	game_init_state(&game_state);
+	game_state.status = GAME_PLAYING;
+	game_state.show_potentiometer_prompt = 0;
+	initialize_ball_velocity(&game_state.balls[0]);
+	while (game_state.level < level)
+		advance_level(&game_state);
+	game_draw_initial_scene(&game_state);
+}
+
+static void write_json(FILE *out) {
+	fprintf(out, "{\n  \"benchmarks\": [\n");
+	for (uint8_t i = 0; i < result_count; i++) {
+		const BenchResult *r = &results[i];
+		fprintf(out, "    {\"name\": \"%s\", \"iterations\": %u, "
+				"\"bus_writes\": %u, \"window_sets\": %u, \"ns\": %llu}%s\n",
+				r->name, r->iterations, r->bus_writes, r->window_sets,
+				(unsigned long long) r->ns, i + 1 < result_count ? "," : "");
+	}
+	fprintf(out, "  ]\n}\n");
+}
+
+/**
+ * @brief  	True when value grew more than pct percent over base
+ */
+static int regressed(uint64_t value, uint64_t base, uint32_t pct) {
+	return value * 100u > base * (100u + pct);
+}
+
+/**
+ * @brief  	Compare the results with a file written by -j
+ * @retval 	Number of regressions, or -1 if the file cannot be read
+ */
+static int compare_baseline(const char *path, uint32_t pct, uint32_t ns_pct) {
+	FILE *in = fopen(path, "r");
+	if (in == NULL)
+		return -1;
+	char line[256];
+	int failures = 0;
+	while (fgets(line, sizeof(line), in) != NULL) {
+		char name[64];
+		unsigned iterations, bus_writes, window_sets;
+		unsigned long long ns;
+		if (sscanf(line, " {\"name\": \"%63[^\"]\", \"iterations\": %u, "
+				"\"bus_writes\": %u, \"window_sets\": %u, \"ns\": %llu",
+				name, &iterations, &bus_writes, &window_sets, &ns) != 5)
+			continue;
+		for (uint8_t i = 0; i < result_count; i++) {
+			const BenchResult *r = &results[i];
+			if (strcmp(r->name, name) != 0)
+				continue;
+			if (regressed(r->bus_writes, bus_writes, pct)
+					|| regressed(r->window_sets, window_sets, pct)) {
+				fprintf(stderr, "REGRESSION %s: bus_writes %u -> %u, "
+						"window_sets %u -> %u\n", name, bus_writes,
+						r->bus_writes, window_sets, r->window_sets);
+				failures++;
+			}
+			if (ns_pct != 0 && regressed(r->ns, ns, ns_pct)) {
+				fprintf(stderr, "REGRESSION %s: ns %llu -> %llu\n", name, ns,
+						(unsigned long long) r->ns);
+				failures++;
+			}
+		}
+	}
+	fclose(in);
+	return failures;
+}
+
+int main(int argc, char **argv) {
+	const char *json_path = NULL;
+	const char *baseline_path = NULL;
+	uint32_t pct = 5;
+	uint32_t ns_pct = 0;
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "-j") == 0 && i + 1 < argc)
+			json_path = argv[++i];
+		else if (strcmp(argv[i], "-b") == 0 && i + 1 < argc)
+			baseline_path = argv[++i];
+		else if (strcmp(argv[i], "-r") == 0 && i + 1 < argc)
+			pct = (uint32_t) strtoul(argv[++i], NULL, 10);
+		else if (strcmp(argv[i], "-T") == 0 && i + 1 < argc)
+			ns_pct = (uint32_t) strtoul(argv[++i], NULL, 10);
+		else {
+			fprintf(stderr, "usage: %s [-j out.json] [-b baseline.json] "
+					"[-r pct] [-T pct]\n", argv[0]);
+			return 2;
+		}
+	}
+
+	host_lcd_reset();
+	MX_DMA_Init();
+	lcd_init();
+
+	bench_run("lcd_fill_screen", 50, bench_fill_screen);
+	bench_run("lcd_fill_brick", 2000, bench_fill_brick);
+	bench_run("lcd_draw_circle_ball", 2000, bench_draw_circle_ball);
+	bench_run("lcd_draw_circle_outline", 500, bench_draw_circle_outline);
+	bench_run("lcd_show_string_opaque", 500, bench_show_string_opaque);
+	bench_run("lcd_show_string_overlay", 500, bench_show_string_overlay);
+	bench_run("lcd_show_picture", 50, bench_show_picture);
+	bench_run("lcd_draw_line_diagonal", 500, bench_draw_line_diagonal);
+	bench_run("lcd_draw_line_axis", 500, bench_draw_line_axis);
+
+	start_game(1);
+	bench_run("game_initial_scene", 50, bench_initial_scene);
+	bench_run("game_frame", GAME_FRAMES, bench_game_frame);
+	start_game(2);
+	bench_run("game_frame_drop_in", GAME_FRAMES, bench_game_frame);
+
+	printf("%-26s %10s %12s %12s %12s\n", "benchmark", "iterations",
+			"bus_writes", "window_sets", "ns");
+	for (uint8_t i = 0; i < result_count; i++) {
+		const BenchResult *r = &results[i];
+		printf("%-26s %10u %12u %12u %12llu\n", r->name, r->iterations,
+				r->bus_writes, r->window_sets, (unsigned long long) r->ns);
+	}
+
+	if (json_path != NULL) {
+		FILE *out = fopen(json_path, "w");
+		if (out == NULL) {
+			fprintf(stderr, "cannot write %s\n", json_path);
+			return 1;
+		}
+		write_json(out);
+		fclose(out);
+	}
+
+	if (baseline_path != NULL) {
+		int failures = compare_baseline(baseline_path, pct, ns_pct);
+		if (failures < 0) {
+			fprintf(stderr, "cannot read %s\n", baseline_path);
+			return 1;
+		}
+		printf("baseline %s: %d regression(s)\n", baseline_path, failures);
+		if (failures > 0)
+			return 1;
+	}
+	return 0;
+}
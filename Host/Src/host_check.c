@@ -0,0 +1,118 @@
+/*
+ * host_check.c
+ *
+ * Checks of game_logic.c edge cases that a played session rarely reaches,
+ * run against the host build. Each check prints one line; the exit status
+ * is 1 if any failed.
+ *
+ * Usage: brick_check
+ */
+
+/* Includes */
+#include "game_ui.h"
+#include "game_logic.h"
+#include "frame_scheduler.h"
+
+#include <stdio.h>
+
+/* Variables */
+static GameState game_state;
+static uint32_t failures = 0;
+
+// Sub-pixel horizontal velocities, raw Q16.16 px/s: with the 20 ms step
+// the smallest move to a wall is a few raw units, far below one pixel
+static const fix16_t tiny_dx[] = { 1, -1, 2, -2, 17, -17, 300, -300, 479, -479 };
+
+/* Functions */
+static void check(const char *name, uint8_t ok) {
+	printf("%-32s %s\n", name, ok ? "ok" : "FAIL");
+	if (!ok)
+		failures++;
+}
+
+/**
+ * @brief  	A fresh level with the paddle at rest at x and one ball at (x, y)
+ */
+static Ball* setup(uint16_t paddle_x, int16_t x, int16_t y, fix16_t dx, fix16_t dy) {
+	game_seed(&game_state, 1);
+	game_init_state(&game_state);
+	Paddle *paddle = &game_state.paddle;
+	paddle->x = paddle_x;
+	paddle->prev_x = paddle_x;
+	paddle->sample_x = paddle_x;
+	paddle->velocity = 0;
+	Ball *ball = &game_state.balls[0];
+	ball->x = FIX16_FROM_INT(x);
+	ball->y = FIX16_FROM_INT(y);
+	ball->dx = dx;
+	ball->dy = dy;
+	return ball;
+}
+
+/**
+ * @brief  	A ball in open space with a near-zero dx keeps its velocity:
+ *          no wall contact is reported from across the screen
+ */
+static void check_tiny_dx_walls(void) {
+	uint8_t ok = 1;
+	for (uint8_t i = 0; i < sizeof(tiny_dx) / sizeof(tiny_dx[0]); i++) {
+		for (int16_t x = 20; x <= SCREEN_WIDTH - 20; x++) {
+			Ball *ball = setup(0, x, 200, tiny_dx[i], FIX16_FROM_INT(V_MIN));
+			step_world(&game_state, FIX16_FROM_MS(FRAME_STEP_MS));
+			if (ball->dx != tiny_dx[i] || ball->dy != FIX16_FROM_INT(V_MIN))
+				ok = 0;
+		}
+	}
+	check("sweep tiny dx: no wall contact", ok);
+}
+
+/**
+ * @brief  	A ball falling beside the paddle, well clear of it, with a
+ *          near-zero dx is not rebounded
+ */
+static void check_tiny_dx_paddle(void) {
+	uint8_t ok = 1;
+	for (uint8_t i = 0; i < sizeof(tiny_dx) / sizeof(tiny_dx[0]); i++) {
+		for (int16_t x = 14; x <= 33; x++) {
+			for (int16_t y = SCREEN_HEIGHT - 60; y <= SCREEN_HEIGHT - 15; y++) {
+				Ball *ball = setup(90, x, y, tiny_dx[i], FIX16_FROM_INT(V_MAX));
+				step_world(&game_state, FIX16_FROM_MS(FRAME_STEP_MS));
+				if (game_state.ball_count != 1 || ball->dy <= 0)
+					ok = 0;
+			}
+		}
+	}
+	check("sweep tiny dx: no paddle contact", ok);
+}
+
+/**
+ * @brief  	The paddle velocity returns to exactly 0 once the paddle stops,
+ *          whichever way it moved
+ */
+static void check_paddle_velocity_settles(void) {
+	uint8_t ok = 1;
+	for (int8_t dir = -1; dir <= 1; dir += 2) {
+		for (uint8_t moves = 1; moves <= 10; moves++) {
+			Paddle paddle = { .x = 100, .sample_x = 100 };
+			for (uint8_t i = 0; i < moves; i++) {
+				paddle.x += dir * (int16_t) (i % 3 + 1);
+				game_track_paddle(&paddle, FIX16_FROM_MS(FRAME_STEP_MS));
+			}
+			if (paddle.velocity == 0 || (paddle.velocity > 0) != (dir > 0))
+				ok = 0;
+			for (uint8_t i = 0; i < 40; i++)
+				game_track_paddle(&paddle, FIX16_FROM_MS(FRAME_STEP_MS));
+			if (paddle.velocity != 0)
+				ok = 0;
+		}
+	}
+	check("paddle velocity settles at 0", ok);
+}
+
+int main(void) {
+	check_tiny_dx_walls();
+	check_tiny_dx_paddle();
+	check_paddle_velocity_settles();
+	printf("%lu check(s) failed\n", (unsigned long) failures);
+	return failures ? 1 : 0;
+}
@@ -0,0 +1,204 @@
+/*
+ * host_hal.c
+ *
+ * Host implementation of the HAL calls used by the game sources.
+ */
+
+/* Includes */
+#include "main.h"
+#include "spi.h"
+#include "adc.h"
+#include "fsmc.h"
+#include "host_hal.h"
+#include "button.h"
+#include "led_7seg.h"
+#include "potentiometer.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Variables */
+GPIO_TypeDef host_gpio[7];
+SPI_HandleTypeDef hspi1;
+SRAM_HandleTypeDef hsram1;
+ADC_HandleTypeDef hadc1;
+
+static uint32_t host_tick = 0;
+static uint16_t host_buttons = 0;
+static SPI_HandleTypeDef *host_spi_active = NULL;	// DMA transfer in flight
+static uint8_t host_spi_rx = 0;
+static uint16_t *host_adc_ring = NULL;		// circular DMA target, NULL until started
+static uint32_t host_adc_length = 0;
+static uint32_t host_adc_index = 0;
+static uint16_t host_potentiometer = 2048;	// 12-bit reading of the knob
+
+/* Functions */
+void Error_Handler(void) {
+	fprintf(stderr, "Error_Handler called\n");
+	abort();
+}
+
+/**
+ * @brief  	Finish SPI DMA transfers until the bus is idle
+ * @note  	Each completion may start the next queued transfer
+ */
+static void host_spi_drain(void) {
+	while (host_spi_active != NULL) {
+		SPI_HandleTypeDef *hspi = host_spi_active;
+		host_spi_active = NULL;
+		if (host_spi_rx)
+			HAL_SPI_RxCpltCallback(hspi);
+		else
+			HAL_SPI_TxCpltCallback(hspi);
+	}
+}
+
+/**
+ * @brief  	One ADC1 sequence, as a TIM2 update triggers it
+ * @note  	The knob reading carries a little deterministic noise so the
+ *          filter has something to do
+ */
+static void host_adc_convert(void) {
+	if (host_adc_ring == NULL)
+		return;
+	static const int8_t noise[8] = { 0, 3, -2, 5, -4, 1, -6, 2 };
+	for (uint32_t i = 0; i < POTENTIOMETER_CHANNELS; i++) {
+		int32_t value = 0;
+		if (i == POTENTIOMETER_RANK) {
+			value = host_potentiometer + noise[host_tick % 8];
+			value = value < 0 ? 0 : value > 4095 ? 4095 : value;
+		}
+		host_adc_ring[host_adc_index++] = (uint16_t) value;
+	}
+	if (host_adc_index == host_adc_length / 2)
+		HAL_ADC_ConvHalfCpltCallback(&hadc1);
+	if (host_adc_index == host_adc_length) {
+		host_adc_index = 0;
+		HAL_ADC_ConvCpltCallback(&hadc1);
+	}
+}
+
+void host_hal_advance(uint32_t ms) {
+	// Each millisecond runs the TIM2 (button scan) and TIM4 (7-segment)
+	// interrupts and the ADC sequence TIM2 triggers; SPI1 transfers finish
+	// before the next millisecond
+	while (ms-- > 0) {
+		host_tick++;
+		button_timer_tick();
+		led_7seg_display();
+		host_adc_convert();
+		host_spi_drain();
+	}
+}
+
+void host_hal_set_potentiometer(uint16_t reading) {
+	host_potentiometer = reading;
+}
+
+void host_hal_set_buttons(uint16_t pressed) {
+	host_buttons = pressed;
+}
+
+uint32_t HAL_GetTick(void) {
+	return host_tick;
+}
+
+void HAL_IncTick(void) {
+	host_tick++;
+}
+
+void HAL_Delay(uint32_t Delay) {
+	host_tick += Delay;
+}
+
+void HAL_GPIO_WritePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin,
+		GPIO_PinState PinState) {
+	if (PinState == GPIO_PIN_RESET)
+		GPIOx->odr &= ~GPIO_Pin;
+	else
+		GPIOx->odr |= GPIO_Pin;
+}
+
+GPIO_PinState HAL_GPIO_ReadPin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin) {
+	return (GPIOx->odr & GPIO_Pin) ? GPIO_PIN_SET : GPIO_PIN_RESET;
+}
+
+/**
+ * @brief  	Build the 74HC165 chain word for the injected buttons
+ * @note  	Inverse of the bit -> button mapping in button_decode();
+ *          lines are active low
+ */
+static uint16_t host_button_shift_word(void) {
+	uint16_t word = 0xffff;
+	uint16_t mask = 0x8000;
+	for (int i = 0; i < 16; i++) {
+		int button_index;
+		if (i <= 3)
+			button_index = i + 4;
+		else if (i <= 7)
+			button_index = 7 - i;
+		else if (i <= 11)
+			button_index = i + 4;
+		else
+			button_index = 23 - i;
+		if (host_buttons & (1u << button_index))
+			word &= ~mask;
+		mask >>= 1;
+	}
+	return word;
+}
+
+HAL_StatusTypeDef HAL_SPI_Receive(SPI_HandleTypeDef *hspi, uint8_t *pData,
+		uint16_t Size, uint32_t Timeout) {
+	(void) hspi;
+	(void) Timeout;
+	uint16_t word = host_button_shift_word();
+	memcpy(pData, &word, Size < sizeof(word) ? Size : sizeof(word));
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_SPI_Receive_DMA(SPI_HandleTypeDef *hspi, uint8_t *pData,
+		uint16_t Size) {
+	if (host_spi_active != NULL)
+		return HAL_BUSY;
+	uint16_t word = host_button_shift_word();
+	memcpy(pData, &word, Size < sizeof(word) ? Size : sizeof(word));
+	host_spi_active = hspi;
+	host_spi_rx = 1;
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_SPI_Transmit_DMA(SPI_HandleTypeDef *hspi, uint8_t *pData,
+		uint16_t Size) {
+	(void) pData;
+	(void) Size;
+	if (host_spi_active != NULL)
+		return HAL_BUSY;
+	host_spi_active = hspi;
+	host_spi_rx = 0;
+	return HAL_OK;
+}
+
+HAL_SPI_StateTypeDef HAL_SPI_GetState(SPI_HandleTypeDef *hspi) {
+	(void) hspi;
+	return host_spi_active != NULL ? HAL_SPI_STATE_BUSY : HAL_SPI_STATE_READY;
+}
+
+HAL_StatusTypeDef HAL_SPI_Transmit(SPI_HandleTypeDef *hspi, uint8_t *pData,
+		uint16_t Size, uint32_t Timeout) {
+	(void) hspi;
+	(void) pData;
+	(void) Size;
+	(void) Timeout;
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_ADC_Start_DMA(ADC_HandleTypeDef *hadc, uint32_t *pData,
+		uint32_t Length) {
+	(void) hadc;
+	host_adc_ring = (uint16_t*) pData;
+	host_adc_length = Length;
+	host_adc_index = 0;
+	return HAL_OK;
+}
@@ -0,0 +1,166 @@
+/*
+ * host_lcd.c
+ *
+ * Minimal ILI9341 command decoder. Handles column/page address set, memory
+ * write/read and the ID read issued by lcd_init(); every other command is
+ * counted and its parameters ignored.
+ */
+
+/* Includes */
+#include "host_lcd.h"
+
+#include <stdio.h>
+#include <string.h>
+
+/* Variables */
+uint16_t host_lcd_framebuffer[HOST_LCD_HEIGHT][HOST_LCD_WIDTH];
+HostLcdStats host_lcd_stats;
+
+static uint16_t cmd = 0;
+static uint8_t param_index = 0;
+static uint16_t col_start = 0, col_end = HOST_LCD_WIDTH - 1;
+static uint16_t page_start = 0, page_end = HOST_LCD_HEIGHT - 1;
+static uint16_t cur_x = 0, cur_y = 0;
+static uint8_t read_index = 0;
+
+static const uint16_t lcd_id_sequence[4] = { 0x00, 0x00, 0x93, 0x41 };
+
+/* Functions */
+void host_lcd_write_reg(uint16_t reg) {
+	host_lcd_stats.reg_writes++;
+	cmd = reg;
+	param_index = 0;
+	read_index = 0;
+	if (reg == 0x2c || reg == 0x2e) {
+		cur_x = col_start;
+		cur_y = page_start;
+	}
+	if (reg == 0x2c)
+		host_lcd_stats.window_sets++;
+}
+
+/**
+ * @brief  	Address set parameters arrive as high/low byte pairs
+ */
+static void set_param(uint16_t *start, uint16_t *end, uint16_t data) {
+	switch (param_index) {
+	case 0:
+		*start = (*start & 0x00ff) | (data & 0xff) << 8;
+		break;
+	case 1:
+		*start = (*start & 0xff00) | (data & 0xff);
+		break;
+	case 2:
+		*end = (*end & 0x00ff) | (data & 0xff) << 8;
+		break;
+	case 3:
+		*end = (*end & 0xff00) | (data & 0xff);
+		break;
+	default:
+		break;
+	}
+	param_index++;
+}
+
+static void advance_cursor(void) {
+	if (++cur_x > col_end) {
+		cur_x = col_start;
+		if (++cur_y > page_end)
+			cur_y = page_start;
+	}
+}
+
+void host_lcd_write_data(uint16_t data) {
+	host_lcd_stats.data_writes++;
+	switch (cmd) {
+	case 0x2a:
+		set_param(&col_start, &col_end, data);
+		break;
+	case 0x2b:
+		set_param(&page_start, &page_end, data);
+		break;
+	case 0x2c:
+		host_lcd_stats.pixel_writes++;
+		if (cur_x < HOST_LCD_WIDTH && cur_y < HOST_LCD_HEIGHT)
+			host_lcd_framebuffer[cur_y][cur_x] = data;
+		advance_cursor();
+		break;
+	default:
+		break;
+	}
+}
+
+void host_lcd_dma_write(uint16_t data) {
+	host_lcd_stats.dma_writes++;
+	host_lcd_write_data(data);
+}
+
+uint16_t host_lcd_read_data(void) {
+	host_lcd_stats.reads++;
+	uint8_t index = read_index++;
+	if (cmd == 0xd3)
+		return index < 4 ? lcd_id_sequence[index] : 0;
+	if (cmd == 0x2e) {
+		// Dummy read, then R8:G8, then B8 as lcd_read_point() expects
+		uint16_t pixel = 0;
+		if (cur_x < HOST_LCD_WIDTH && cur_y < HOST_LCD_HEIGHT)
+			pixel = host_lcd_framebuffer[cur_y][cur_x];
+		uint16_t r8 = (pixel >> 11) << 3;
+		uint16_t g8 = ((pixel >> 5) & 0x3f) << 2;
+		uint16_t b8 = (pixel & 0x1f) << 3;
+		if (index == 1)
+			return r8 << 8 | g8;
+		if (index == 2)
+			return b8 << 8;
+	}
+	return 0;
+}
+
+void host_lcd_reset(void) {
+	memset(host_lcd_framebuffer, 0, sizeof(host_lcd_framebuffer));
+	cmd = 0;
+	param_index = 0;
+	col_start = 0;
+	col_end = HOST_LCD_WIDTH - 1;
+	page_start = 0;
+	page_end = HOST_LCD_HEIGHT - 1;
+	host_lcd_reset_stats();
+}
+
+void host_lcd_reset_stats(void) {
+	memset(&host_lcd_stats, 0, sizeof(host_lcd_stats));
+}
+
+uint32_t host_lcd_bus_writes(const HostLcdStats *stats) {
+	return stats->reg_writes + stats->data_writes;
+}
+
+/**
+ * @brief  	FNV-1a over the framebuffer, for comparing renderer output
+ */
+uint32_t host_lcd_checksum(void) {
+	uint32_t hash = 2166136261u;
+	const uint8_t *p = (const uint8_t*) host_lcd_framebuffer;
+	for (size_t i = 0; i < sizeof(host_lcd_framebuffer); i++) {
+		hash ^= p[i];
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+int host_lcd_save_ppm(const char *path) {
+	FILE *f = fopen(path, "wb");
+	if (f == NULL)
+		return -1;
+	fprintf(f, "P6\n%d %d\n255\n", HOST_LCD_WIDTH, HOST_LCD_HEIGHT);
+	for (int y = 0; y < HOST_LCD_HEIGHT; y++) {
+		for (int x = 0; x < HOST_LCD_WIDTH; x++) {
+			uint16_t c = host_lcd_framebuffer[y][x];
+			uint8_t rgb[3] = { (c >> 11) << 3, ((c >> 5) & 0x3f) << 2,
+					(c & 0x1f) << 3 };
+			fwrite(rgb, 1, 3, f);
+		}
+	}
+	fclose(f);
+	return 0;
+}
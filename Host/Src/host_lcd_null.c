@@ -0,0 +1,53 @@
+/*
+ * host_lcd_null.c
+ *
+ * Drop-in for host_lcd.c when nothing is looked at: every bus access is
+ * discarded, so the batch simulator pays only for the game code.
+ */
+
+/* Includes */
+#include "host_lcd.h"
+
+#include <string.h>
+
+/* Variables */
+uint16_t host_lcd_framebuffer[HOST_LCD_HEIGHT][HOST_LCD_WIDTH];
+HostLcdStats host_lcd_stats;
+
+/* Functions */
+void host_lcd_write_reg(uint16_t reg) {
+	(void) reg;
+}
+
+void host_lcd_write_data(uint16_t data) {
+	(void) data;
+}
+
+void host_lcd_dma_write(uint16_t data) {
+	(void) data;
+}
+
+uint16_t host_lcd_read_data(void) {
+	return 0;
+}
+
+void host_lcd_reset(void) {
+	host_lcd_reset_stats();
+}
+
+void host_lcd_reset_stats(void) {
+	memset(&host_lcd_stats, 0, sizeof(host_lcd_stats));
+}
+
+uint32_t host_lcd_bus_writes(const HostLcdStats *stats) {
+	return stats->reg_writes + stats->data_writes;
+}
+
+uint32_t host_lcd_checksum(void) {
+	return 0;
+}
+
+int host_lcd_save_ppm(const char *path) {
+	(void) path;
+	return -1;
+}
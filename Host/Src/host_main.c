@@ -0,0 +1,452 @@
+/*
+ * host_main.c
+ *
+ * Headless session runner: boots the LCD, shows the start screen, then plays
+ * a scripted game through the real game_logic/game_ui code and reports the
+ * emulated FSMC bus traffic.
+ *
+ * Usage: brick_host [-f frames] [-o screen.ppm] [-n] [-k] [-d] [-t ns] [-p]
+ *                   [-s seed] [-w session] [-r session]
+ *   -n  leave the paddle alone so balls are lost
+ *   -k  steer with the potentiometer instead of the buttons
+ *   -d  start on level 2 so the bricks drop in
+ *   -t  charge each rendered bus write ns nanoseconds of virtual time, so
+ *       the frame scheduler has to catch up with a slow display
+ *   -p  print the per-zone profiler report (wall-clock time on this machine)
+ *   -s  seed for game_seed() (default 1)
+ *   -w  record the session (seed plus per-tick input and steps) to a file
+ *   -r  replay a recorded session instead of the autopilot; prints whether
+ *       the GameState trace after every step matches the recording
+ *
+ * After the last frame the screen is compared with a full redraw of the same
+ * state (game_draw_initial_scene); any difference is a partial-update bug.
+ */
+
+/* Includes */
+#include "dma.h"
+#include "lcd.h"
+#include "picture.h"
+#include "button.h"
+#include "game_ui.h"
+#include "game_logic.h"
+#include "frame_scheduler.h"
+#include "profiler.h"
+#include "spi_bus.h"
+#include "session.h"
+#include "input.h"
+#include "potentiometer.h"
+#include "host_hal.h"
+#include "host_lcd.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Types */
+// Whole session as saved by -w: the ring is drained into / fed from this
+typedef struct {
+	uint32_t seed;
+	uint8_t drop_in;
+	uint32_t trace;				// state trace the recording ended with
+	session_entry_t *entries;
+	uint32_t count;
+	uint32_t capacity;
+	uint32_t next;				// replay: first entry not yet pushed
+} HostSession;
+
+/* Variables */
+static GameState game_state;
+static HostSession replay;
+
+/* Functions */
+static void print_stats(const char *phase, const HostLcdStats *stats,
+		uint32_t frames) {
+	uint32_t writes = host_lcd_bus_writes(stats);
+	printf("%-14s bus_writes=%-9u cpu_writes=%-9u pixels=%-9u windows=%-7u",
+			phase, writes, writes - stats->dma_writes, stats->pixel_writes,
+			stats->window_sets);
+	if (frames > 1)
+		printf(" per_frame=%u", writes / frames);
+	printf("\n");
+}
+
+static void print_line(const char *line) {
+	printf("%s\n", line);
+}
+
+static uint32_t fnv1a(uint32_t hash, const void *data, size_t size) {
+	const uint8_t *bytes = data;
+	for (size_t i = 0; i < size; i++)
+		hash = (hash ^ bytes[i]) * 16777619u;
+	return hash;
+}
+
+/**
+ * @brief  	Keep the session ring moving: drain a recording into replay,
+ *          or top the ring up from replay while it is played back
+ */
+static void session_sync(void) {
+	if (session.mode == SESSION_REPLAYING) {
+		while (replay.next < replay.count && session_push(replay.entries[replay.next]))
+			replay.next++;
+		return;
+	}
+	while (session.count > 0) {
+		if (replay.count == replay.capacity) {
+			replay.capacity = replay.capacity ? replay.capacity * 2 : 1024;
+			replay.entries = realloc(replay.entries,
+					replay.capacity * sizeof(session_entry_t));
+			if (replay.entries == NULL) {
+				fprintf(stderr, "out of memory\n");
+				exit(1);
+			}
+		}
+		replay.count += session_pop(&replay.entries[replay.count],
+				(uint16_t) (replay.capacity - replay.count > 0xFFFF ?
+						0xFFFF : replay.capacity - replay.count));
+	}
+}
+
+/**
+ * @brief  	Session file: "BRKS", seed, flags (bit 0 = -d), entry count,
+ *          final state trace, then the entries; all 32-bit native order
+ */
+static int replay_save(const char *path, uint8_t drop_in, uint32_t trace) {
+	FILE *out = fopen(path, "wb");
+	if (out == NULL)
+		return -1;
+	uint32_t header[4] = { replay.seed, drop_in, replay.count, trace };
+	int ok = fwrite("BRKS", 1, 4, out) == 4
+			&& fwrite(header, sizeof(header), 1, out) == 1
+			&& fwrite(replay.entries, sizeof(session_entry_t), replay.count, out)
+					== replay.count;
+	return fclose(out) == 0 && ok ? 0 : -1;
+}
+
+static int replay_load(const char *path) {
+	FILE *in = fopen(path, "rb");
+	if (in == NULL)
+		return -1;
+	char magic[4];
+	uint32_t header[4];
+	int ok = fread(magic, 1, 4, in) == 4 && memcmp(magic, "BRKS", 4) == 0
+			&& fread(header, sizeof(header), 1, in) == 1;
+	if (ok) {
+		replay.seed = header[0];
+		replay.drop_in = header[1] & 1;
+		replay.count = header[2];
+		replay.trace = header[3];
+		replay.capacity = replay.count;
+		replay.entries = malloc(replay.count * sizeof(session_entry_t) + 1);
+		ok = replay.entries != NULL
+				&& fread(replay.entries, sizeof(session_entry_t), replay.count, in)
+						== replay.count;
+	}
+	fclose(in);
+	return ok ? 0 : -1;
+}
+
+/**
+ * @brief  	Reference for the old start-screen path: the CPU writes every
+ *          pixel itself
+ */
+static void legacy_show_picture(uint16_t x, uint16_t y, uint16_t length,
+		uint16_t width, const uint16_t pic[]) {
+	lcd_set_address(x, y, x + length - 1, y + width - 1);
+	for (uint32_t k = 0; k < (uint32_t) length * width; k++)
+		LCD_BUS_WR_DATA(pic[k]);
+}
+
+/**
+ * @brief  	Compare the DMA blit of the start screen with the CPU loop
+ */
+static void report_picture_speedup(void) {
+	static uint16_t saved[HOST_LCD_HEIGHT][HOST_LCD_WIDTH];
+	memcpy(saved, host_lcd_framebuffer, sizeof(saved));
+	host_lcd_reset_stats();
+	legacy_show_picture(0, 0, 240, 320, gImage_BK);
+	HostLcdStats legacy = host_lcd_stats;
+	uint32_t legacy_hash = host_lcd_checksum();
+
+	host_lcd_reset_stats();
+	lcd_show_picture(0, 0, 240, 320, gImage_BK);
+	HostLcdStats dma = host_lcd_stats;
+
+	uint32_t legacy_cpu = host_lcd_bus_writes(&legacy) - legacy.dma_writes;
+	uint32_t dma_cpu = host_lcd_bus_writes(&dma) - dma.dma_writes;
+	printf("picture        legacy_cpu_writes=%u dma_cpu_writes=%u "
+			"cpu_speedup=%.0fx identical=%s\n", legacy_cpu, dma_cpu,
+			(double) legacy_cpu / dma_cpu,
+			legacy_hash == host_lcd_checksum() ? "yes" : "NO");
+	memcpy(host_lcd_framebuffer, saved, sizeof(saved));
+}
+
+/**
+ * @brief  	Count pixels that differ from a full redraw of the current state
+ */
+static uint32_t scene_mismatch(const GameState *state) {
+	static uint16_t partial[HOST_LCD_HEIGHT][HOST_LCD_WIDTH];
+	uint32_t diff = 0;
+	memcpy(partial, host_lcd_framebuffer, sizeof(partial));
+	game_draw_initial_scene(state);
+	for (int y = 0; y < HOST_LCD_HEIGHT; y++) {
+		for (int x = 0; x < HOST_LCD_WIDTH; x++)
+			diff += partial[y][x] != host_lcd_framebuffer[y][x];
+	}
+	memcpy(host_lcd_framebuffer, partial, sizeof(partial));
+	return diff;
+}
+
+/**
+ * @brief  	Hold the button under the paddle's path towards the lowest ball,
+ *          aiming off-center (by an offset that changes with the score) so
+ *          the rebound angle varies
+ */
+static uint16_t paddle_autopilot(const GameState *state) {
+	if (state->ball_count == 0)
+		return 0;
+	const Ball *target = &state->balls[0];
+	for (int i = 1; i < state->ball_count; i++) {
+		if (state->balls[i].y > target->y)
+			target = &state->balls[i];
+	}
+	int16_t center = state->paddle.x + state->paddle.width / 2
+			+ ((int16_t) (state->score / 10 % 5) - 2) * 8;
+	if (BALL_PX(target) < center - 4)
+		return 1u << 8;
+	if (BALL_PX(target) > center + 4)
+		return 1u << 9;
+	return 0;
+}
+
+/**
+ * @brief  	Turn the knob so the paddle lands under the lowest ball, with the
+ *          same score-dependent aim offset as paddle_autopilot()
+ * @retval 	12-bit ADC reading
+ */
+static uint16_t knob_autopilot(const GameState *state) {
+	if (state->ball_count == 0)
+		return 2048;
+	const Ball *target = &state->balls[0];
+	for (int i = 1; i < state->ball_count; i++) {
+		if (state->balls[i].y > target->y)
+			target = &state->balls[i];
+	}
+	int32_t x = BALL_PX(target) - state->paddle.width / 2
+			- ((int32_t) (state->score / 10 % 5) - 2) * 8;
+	int32_t max_x = SCREEN_WIDTH - state->paddle.width;
+	x = x < 0 ? 0 : x > max_x ? max_x : x;
+	return (uint16_t) (x * 4095 / max_x);
+}
+
+/**
+ * @brief  	Press and release a button, each long enough to pass the debounce
+ */
+static void tap_button(uint8_t index) {
+	for (uint32_t t = 0; t <= input_config.debounce_ms; t += input_config.scan_ms)
+		input_update(1u << index);
+	for (uint32_t t = 0; t <= input_config.debounce_ms; t += input_config.scan_ms)
+		input_update(0);
+	input_event_t event;
+	while (input_pop(&event)) {
+	}
+}
+
+int main(int argc, char **argv) {
+	uint32_t frames = 500;
+	const char *ppm_path = NULL;
+	uint8_t autopilot = 1;
+	uint8_t knob = 0;
+	uint8_t drop_in = 0;
+	uint32_t ns_per_write = 0;
+	uint8_t profile = 0;
+	uint32_t seed = 1;
+	const char *record_path = NULL;
+	const char *replay_path = NULL;
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "-f") == 0 && i + 1 < argc)
+			frames = (uint32_t) strtoul(argv[++i], NULL, 10);
+		else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc)
+			ppm_path = argv[++i];
+		else if (strcmp(argv[i], "-n") == 0)
+			autopilot = 0;
+		else if (strcmp(argv[i], "-k") == 0)
+			knob = 1;
+		else if (strcmp(argv[i], "-d") == 0)
+			drop_in = 1;
+		else if (strcmp(argv[i], "-p") == 0)
+			profile = 1;
+		else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc)
+			ns_per_write = (uint32_t) strtoul(argv[++i], NULL, 10);
+		else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc)
+			seed = (uint32_t) strtoul(argv[++i], NULL, 0);
+		else if (strcmp(argv[i], "-w") == 0 && i + 1 < argc)
+			record_path = argv[++i];
+		else if (strcmp(argv[i], "-r") == 0 && i + 1 < argc)
+			replay_path = argv[++i];
+		else {
+			fprintf(stderr, "usage: %s [-f frames] [-o screen.ppm] [-n] [-k] [-d] "
+					"[-t ns] [-p] [-s seed] [-w session] [-r session]\n", argv[0]);
+			return 2;
+		}
+	}
+
+	if (replay_path != NULL) {
+		if (replay_load(replay_path) != 0) {
+			fprintf(stderr, "cannot read session %s\n", replay_path);
+			return 1;
+		}
+		seed = replay.seed;
+		drop_in = replay.drop_in;
+	}
+
+	host_lcd_reset();
+	MX_DMA_Init();
+	lcd_init();
+	spi_bus_init();
+	input_init(NULL);
+	potentiometer_init();
+	lcd_show_picture(0, 0, 240, 320, gImage_BK);
+	lcd_show_string_center(0, 164, "PRESS BUTTON 1 TO PLAY", WHITE, 0, 16, 1);
+	HostLcdStats boot = host_lcd_stats;
+
+	host_lcd_reset_stats();
+	tap_button(0);
+	game_seed(&game_state, seed);
+	game_init_state(&game_state);
+	game_state.show_potentiometer_prompt = 1;
+	game_state.status = GAME_PLAYING;
+	game_draw_initial_scene(&game_state);
+	tap_button(2);
+	game_state.show_potentiometer_prompt = 0;
+	initialize_ball_velocity(&game_state.balls[0]);
+	if (drop_in)
+		advance_level(&game_state);
+	game_draw_initial_scene(&game_state);
+	HostLcdStats scene = host_lcd_stats;
+
+	host_lcd_reset_stats();
+	frame_scheduler_init();
+	profiler_init();
+	spi_bus_reset_stats();
+	input_init(NULL); // as main.c does when the session starts
+	replay.seed = seed;
+	if (replay_path != NULL)
+		session_replay_start(seed);
+	else
+		session_record_start(seed);
+	uint32_t trace = 2166136261u;
+	uint32_t max_frame = 0, played = 0;
+	// One iteration per main-loop pass of main.c: take a scan, poll, steps,
+	// render
+	while (played < frames && game_state.status == GAME_PLAYING) {
+		session_sync();
+		uint32_t before = host_lcd_bus_writes(&host_lcd_stats);
+		if (knob) {
+			host_hal_set_buttons(0);
+			if (autopilot)
+				host_hal_set_potentiometer(knob_autopilot(&game_state));
+		} else {
+			host_hal_set_buttons(autopilot ? paddle_autopilot(&game_state) : 0);
+		}
+		uint16_t held;
+		if (!button_take(&held)) {
+			host_hal_advance(1); // until the timer has run the next scan
+			continue;
+		}
+		PROFILE_BEGIN(PROF_ZONE_BUTTON_SCAN);
+		input_update(session_buttons(held));
+		uint8_t pot = session_pot(potentiometer_read());
+		input_event_t event;
+		while (input_pop(&event)) {
+		}
+		PROFILE_END(PROF_ZONE_BUTTON_SCAN);
+		uint8_t steps = session_steps(frame_scheduler_poll());
+		if (steps == 0)
+			continue;
+		PROFILE_BEGIN(PROF_ZONE_FRAME);
+		for (uint8_t i = 0; i < steps; i++) {
+			game_handle_paddle_pot(&game_state, pot);
+			game_handle_paddle_buttons(&game_state);
+			PROFILE_BEGIN(PROF_ZONE_STEP_WORLD);
+			step_world(&game_state, FIX16_FROM_MS(FRAME_STEP_MS));
+			PROFILE_END(PROF_ZONE_STEP_WORLD);
+			trace = fnv1a(trace, &game_state, sizeof(game_state));
+			if (game_state.status != GAME_PLAYING
+					|| game_state.show_potentiometer_prompt)
+				break;
+		}
+		game_render_events(&game_state);
+		if (game_state.status != GAME_PLAYING)
+			break;
+		if (game_state.show_potentiometer_prompt) {
+			// Dismiss the prompt straight away, as main.c does on button 2
+			game_state.show_potentiometer_prompt = 0;
+			initialize_ball_velocity(&game_state.balls[0]);
+			game_draw_initial_scene(&game_state);
+			frame_scheduler_resync();
+		} else {
+			PROFILE_BEGIN(PROF_ZONE_UPDATE_SCREEN);
+			game_update_screen(&game_state);
+			PROFILE_END(PROF_ZONE_UPDATE_SCREEN);
+		}
+		PROFILE_END(PROF_ZONE_FRAME);
+		uint32_t cost = host_lcd_bus_writes(&host_lcd_stats) - before;
+		if (cost > max_frame)
+			max_frame = cost;
+		played++;
+		// A slow LCD makes the next poll owe more than one step
+		host_hal_advance(ns_per_write ? (uint32_t) ((uint64_t) cost * ns_per_write / 1000000u) : 0);
+		input_frame_presented(); // after the LCD time, as on the board
+	}
+	HostLcdStats play = host_lcd_stats;
+	uint8_t replayed = session.mode == SESSION_REPLAYING;
+	session_stop();
+	session_sync();
+
+	print_stats("boot", &boot, 1);
+	report_picture_speedup();
+	print_stats("initial_scene", &scene, 1);
+	print_stats("frames", &play, played);
+	printf("frames=%u max_frame_writes=%u level=%u score=%u lives=%u\n", played,
+			max_frame, game_state.level, (unsigned) game_state.score,
+			game_state.lives);
+	printf("scheduler      frames=%u steps=%u skipped=%u overruns=%u dropped_ms=%u\n",
+			(unsigned) frame_scheduler.frames, (unsigned) frame_scheduler.steps,
+			(unsigned) frame_scheduler.skipped,
+			(unsigned) frame_scheduler.overruns,
+			(unsigned) frame_scheduler.dropped_ms);
+	printf("buttons        scan_ms=%u missed=%u skipped=%u\n", BUTTON_SCAN_MS,
+			(unsigned) button_missed, (unsigned) button_skipped);
+	spi_bus_dump(print_line);
+	printf("potentiometer  blocks=%u position=%u\n",
+			(unsigned) potentiometer_blocks, potentiometer_read());
+	printf("input          presses=%u avg_ms=%.1f min_ms=%u max_ms=%u stale=%u "
+			"overflow=%u\n", (unsigned) input_latency.count,
+			input_latency.count ? (double) input_latency.total / input_latency.count : 0.0,
+			input_latency.count ? (unsigned) input_latency.min : 0,
+			(unsigned) input_latency.max, (unsigned) input_latency.stale,
+			(unsigned) input_overflow);
+	if (profile)
+		profiler_dump(print_line);
+	printf("session        seed=%u entries=%u dropped=%u state_trace_fnv1a=%08x\n",
+			(unsigned) seed, (unsigned) replay.count,
+			(unsigned) session.dropped, trace);
+	if (replay_path != NULL)
+		printf("replay_identical=%s\n", replayed && replay.next == replay.count
+				&& session.count == 0 && session.run_repeat == 0
+				&& trace == replay.trace ? "yes" : "NO");
+	if (record_path != NULL && replay_save(record_path, drop_in, trace) != 0) {
+		fprintf(stderr, "cannot write %s\n", record_path);
+		return 1;
+	}
+	printf("framebuffer_fnv1a=%08x\n", host_lcd_checksum());
+	if (game_state.status == GAME_PLAYING)
+		printf("scene_mismatch_pixels=%u\n", scene_mismatch(&game_state));
+
+	if (ppm_path != NULL && host_lcd_save_ppm(ppm_path) != 0) {
+		fprintf(stderr, "cannot write %s\n", ppm_path);
+		return 1;
+	}
+	return 0;
+}
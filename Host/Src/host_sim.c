@@ -0,0 +1,309 @@
+/*
+ * host_sim.c
+ *
+ * Headless batch simulator for play-testing: many independent games run
+ * through step_world() with the LCD discarded (host_lcd_null.c) and an AI
+ * paddle, spread over forked workers. Reports how far games get and how
+ * quickly lives are lost, and the simulated frames per second.
+ *
+ * Usage: brick_sim [-g games] [-j workers] [-m max_frames] [-e aim_error]
+ *                  [-s seed]
+ *   -g  games to play (default 1000)
+ *   -j  worker processes (default: online CPUs)
+ *   -m  frames after which a game is stopped (default 60000, 20 minutes)
+ *   -e  AI aim error in pixels; each rebound aims up to this far off the
+ *       paddle center, so more error means more misses (default 50)
+ *   -s  seed of game 0; game i uses seed + i (default 1)
+ *
+ * V_MIN, V_MAX, V_X_MAX, K_SPIN and BRICK_*_PERCENT can be overridden at
+ * build time, e.g. make sim BUILD_DIR=build_vmax SIM_DEFS=-DV_MAX=260
+ */
+
+/* Includes */
+#include "lcd.h"
+#include "input.h"
+#include "game_ui.h"
+#include "game_logic.h"
+#include "frame_scheduler.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+
+#define MAX_WORKERS 256
+#define LEVEL_BUCKETS 64			// levels 1..63, the last bucket is 63+
+#define LIFE_BUCKET_FRAMES 50		// one second of play per bucket
+#define LIFE_BUCKETS 1200		// 20 minutes; the last bucket is open-ended
+
+/* Types */
+typedef struct {
+	uint8_t level;
+	uint8_t capped;					// stopped by -m before game over
+	uint32_t frames;
+	uint32_t balls_lost;
+	uint32_t lives_lost;
+} GameResult;
+
+// One per worker so the counters need no locking
+typedef struct {
+	uint64_t life_frames_total;
+	uint32_t lives;
+	uint32_t life_hist[LIFE_BUCKETS];
+} WorkerStats;
+
+/* Variables */
+static GameState game_state;
+// One input scan per frame, taken as is: no debounce, hold or repeat
+static const input_config_t frame_input = { .scan_ms = FRAME_STEP_MS };
+
+/* Functions */
+static uint64_t now_ns(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t) ts.tv_sec * 1000000000u + (uint64_t) ts.tv_nsec;
+}
+
+static uint32_t ai_rand(uint32_t *state) {
+	uint32_t x = *state;
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	*state = x;
+	return x;
+}
+
+/**
+ * @brief  	Buttons the AI holds: follow the lowest falling ball, aiming aim
+ *          pixels off the paddle center
+ */
+static uint16_t ai_buttons(const GameState *state, int16_t aim) {
+	const Ball *target = NULL;
+	for (int i = 0; i < state->ball_count; i++) {
+		const Ball *b = &state->balls[i];
+		if (b->dy > 0 && (target == NULL || b->y > target->y))
+			target = b;
+	}
+	if (target == NULL)
+		return 0;
+	int16_t center = state->paddle.x + state->paddle.width / 2 + aim;
+	if (BALL_PX(target) < center - 2)
+		return 1u << 8;
+	if (BALL_PX(target) > center + 2)
+		return 1u << 9;
+	return 0;
+}
+
+static void record_life(WorkerStats *stats, uint32_t frames) {
+	uint32_t bucket = frames / LIFE_BUCKET_FRAMES;
+	stats->life_hist[bucket < LIFE_BUCKETS ? bucket : LIFE_BUCKETS - 1]++;
+	stats->life_frames_total += frames;
+	stats->lives++;
+}
+
+/**
+ * @brief  	Play one game to game over or max_frames
+ */
+static void play_game(uint32_t seed, uint32_t max_frames, int16_t aim_error,
+		GameResult *result, WorkerStats *stats) {
+	uint32_t ai_state = seed * 2654435761u | 1;
+	int16_t aim = 0;
+	uint32_t life_start = 0;
+
+	input_init(&frame_input);
+	game_seed(&game_state, seed);
+	game_init_state(&game_state);
+	initialize_ball_velocity(&game_state.balls[0]);
+	result->lives_lost = 0;
+
+	uint32_t frame;
+	for (frame = 0; frame < max_frames; frame++) {
+		fix16_t dy = game_state.ball_count ? game_state.balls[0].dy : 0;
+		input_update(ai_buttons(&game_state, aim));
+		input_event_t input_event;
+		while (input_pop(&input_event)) {
+		}
+		game_handle_paddle_buttons(&game_state);
+		step_world(&game_state, FIX16_FROM_MS(FRAME_STEP_MS));
+
+		// New aim after each paddle rebound of the first ball
+		if (aim_error > 0 && dy > 0 && game_state.ball_count
+				&& game_state.balls[0].dy < 0)
+			aim = (int16_t) (ai_rand(&ai_state) % (2 * aim_error + 1)) - aim_error;
+
+		// Nothing is drawn: the events are only counted
+		GameEvent event;
+		while (game_pop_event(&game_state, &event)) {
+			if (event.type == GAME_EVENT_LIFE_LOST
+					|| event.type == GAME_EVENT_GAME_OVER) {
+				record_life(stats, frame + 1 - life_start);
+				result->lives_lost++;
+				life_start = frame + 1;
+			}
+		}
+		if (game_state.status != GAME_PLAYING)
+			break;
+		if (game_state.show_potentiometer_prompt) {
+			// Serve again at once, as a player pressing button 2 would
+			game_state.show_potentiometer_prompt = 0;
+			initialize_ball_velocity(&game_state.balls[0]);
+		}
+	}
+
+	result->level = game_state.level;
+	result->capped = game_state.status == GAME_PLAYING;
+	result->frames = frame < max_frames ? frame + 1 : max_frames;
+	result->balls_lost = game_state.balls_lost;
+}
+
+static int compare_u32(const void *a, const void *b) {
+	uint32_t x = *(const uint32_t*) a, y = *(const uint32_t*) b;
+	return (x > y) - (x < y);
+}
+
+/**
+ * @brief  	Print mean and percentiles of a sample
+ */
+static void print_distribution(const char *name, uint32_t *values, uint32_t n) {
+	if (n == 0)
+		return;
+	uint64_t sum = 0;
+	for (uint32_t i = 0; i < n; i++)
+		sum += values[i];
+	qsort(values, n, sizeof(values[0]), compare_u32);
+	printf("%-14s mean=%.2f p10=%u p50=%u p90=%u max=%u\n", name,
+			(double) sum / n, values[n / 10], values[n / 2],
+			values[n * 9 / 10], values[n - 1]);
+}
+
+/**
+ * @brief  	Percentile of the frames-per-life histogram (bucket lower edge)
+ */
+static uint32_t life_percentile(const uint32_t *hist, uint32_t lives,
+		uint32_t percent) {
+	uint64_t rank = (uint64_t) lives * percent / 100, seen = 0;
+	for (uint32_t b = 0; b < LIFE_BUCKETS; b++) {
+		seen += hist[b];
+		if (seen > rank)
+			return b * LIFE_BUCKET_FRAMES;
+	}
+	return LIFE_BUCKETS * LIFE_BUCKET_FRAMES;
+}
+
+int main(int argc, char **argv) {
+	uint32_t games = 1000;
+	long workers = sysconf(_SC_NPROCESSORS_ONLN);
+	uint32_t max_frames = 60000;
+	int16_t aim_error = 50;
+	uint32_t seed = 1;
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "-g") == 0 && i + 1 < argc)
+			games = (uint32_t) strtoul(argv[++i], NULL, 10);
+		else if (strcmp(argv[i], "-j") == 0 && i + 1 < argc)
+			workers = strtol(argv[++i], NULL, 10);
+		else if (strcmp(argv[i], "-m") == 0 && i + 1 < argc)
+			max_frames = (uint32_t) strtoul(argv[++i], NULL, 10);
+		else if (strcmp(argv[i], "-e") == 0 && i + 1 < argc)
+			aim_error = (int16_t) strtol(argv[++i], NULL, 10);
+		else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc)
+			seed = (uint32_t) strtoul(argv[++i], NULL, 0);
+		else {
+			fprintf(stderr, "usage: %s [-g games] [-j workers] [-m max_frames] "
+					"[-e aim_error] [-s seed]\n", argv[0]);
+			return 2;
+		}
+	}
+	if (workers < 1)
+		workers = 1;
+	if (workers > MAX_WORKERS)
+		workers = MAX_WORKERS;
+	if ((uint32_t) workers > games)
+		workers = games ? games : 1;
+
+	// Shared with the workers; each writes only its own games and stats
+	GameResult *results = mmap(NULL, games * sizeof(GameResult) + 1,
+			PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+	WorkerStats *stats = mmap(NULL, workers * sizeof(WorkerStats),
+			PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+	if (results == MAP_FAILED || stats == MAP_FAILED) {
+		perror("mmap");
+		return 1;
+	}
+
+	lcd_init();
+	uint64_t start = now_ns();
+	for (long w = 0; w < workers; w++) {
+		pid_t pid = fork();
+		if (pid < 0) {
+			perror("fork");
+			return 1;
+		}
+		if (pid == 0) {
+			for (uint32_t g = (uint32_t) w; g < games; g += (uint32_t) workers)
+				play_game(seed + g, max_frames, aim_error, &results[g], &stats[w]);
+			_exit(0);
+		}
+	}
+	int failed = 0;
+	for (long w = 0; w < workers; w++) {
+		int status;
+		if (wait(&status) < 0 || !WIFEXITED(status) || WEXITSTATUS(status) != 0)
+			failed = 1;
+	}
+	double seconds = (double) (now_ns() - start) / 1e9;
+	if (failed) {
+		fprintf(stderr, "a worker failed\n");
+		return 1;
+	}
+
+	uint32_t *levels = malloc(games * sizeof(uint32_t) + 1);
+	uint32_t *balls = malloc(games * sizeof(uint32_t) + 1);
+	uint32_t level_hist[LEVEL_BUCKETS] = { 0 };
+	uint64_t frames = 0;
+	uint32_t capped = 0;
+	for (uint32_t g = 0; g < games; g++) {
+		const GameResult *r = &results[g];
+		levels[g] = r->level;
+		balls[g] = r->balls_lost;
+		level_hist[r->level < LEVEL_BUCKETS ? r->level : LEVEL_BUCKETS - 1]++;
+		frames += r->frames;
+		capped += r->capped;
+	}
+	WorkerStats total = { 0 };
+	for (long w = 0; w < workers; w++) {
+		total.life_frames_total += stats[w].life_frames_total;
+		total.lives += stats[w].lives;
+		for (uint32_t b = 0; b < LIFE_BUCKETS; b++)
+			total.life_hist[b] += stats[w].life_hist[b];
+	}
+
+	printf("games=%u workers=%ld max_frames=%u aim_error=%d seed=%u capped=%u\n",
+			games, workers, max_frames, aim_error, seed, capped);
+	printf("V_MIN=%d V_MAX=%d V_X_MAX=%d K_SPIN=%.3f ball%%=%d plus%%=%d\n",
+			V_MIN, V_MAX, V_X_MAX, (double) K_SPIN, BRICK_BALL_PERCENT,
+			BRICK_PLUS_PERCENT);
+	print_distribution("level", levels, games);
+	print_distribution("balls_lost", balls, games);
+	if (total.lives > 0)
+		printf("%-14s mean=%.1f p10=%u p50=%u p90=%u (lives=%u, %u-frame buckets)\n",
+				"frames_per_life", (double) total.life_frames_total / total.lives,
+				life_percentile(total.life_hist, total.lives, 10),
+				life_percentile(total.life_hist, total.lives, 50),
+				life_percentile(total.life_hist, total.lives, 90), total.lives,
+				LIFE_BUCKET_FRAMES);
+	printf("level_hist    ");
+	for (uint32_t l = 1; l < LEVEL_BUCKETS; l++) {
+		if (level_hist[l])
+			printf(" %u%s:%u", l, l == LEVEL_BUCKETS - 1 ? "+" : "", level_hist[l]);
+	}
+	printf("\n");
+	printf("throughput     frames=%llu seconds=%.3f frames_per_second=%.0f "
+			"per_worker=%.0f\n", (unsigned long long) frames, seconds,
+			frames / seconds, frames / seconds / workers);
+	free(levels);
+	free(balls);
+	return 0;
+}